@@ -0,0 +1,178 @@
+// Usage: convert --to-binary text records           "a op b" lines (as 002_double_calc.cpp takes them) to a record file
+//        convert --to-text records                  a record file back to lines on stdout
+//        convert --results results                  a result file to one number per line on stdout
+//        convert --generate count records           count random records
+// Numbers are written in shortest round-trip form, so text -> binary -> text keeps every value exactly.
+
+// Build: g++ -std=c++17 -O2 convert.cpp record_file.cpp
+
+#include "record_file.h"
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+const char* skipSpaces(const char* p, const char* end)
+{
+	while(p < end && (*p == ' ' || *p == '\t'))
+		++p;
+
+	return p;
+}
+
+bool parseRecord(const std::string& line, CalcRecord& record)
+{
+	const char* end{ line.data() + line.size() };
+	while(end > line.data() && (end[-1] == '\r' || end[-1] == ' ' || end[-1] == '\t'))
+		--end;
+
+	const char* p{ skipSpaces(line.data(), end) };
+	auto parsed{ std::from_chars(p, end, record.x) };
+	if(parsed.ec != std::errc{})
+		return false;
+
+	p = skipSpaces(parsed.ptr, end);
+	if(p == end)
+		return false;
+	record.op = static_cast<std::uint8_t>(*p++);
+
+	p = skipSpaces(p, end);
+	parsed = std::from_chars(p, end, record.y);
+
+	return parsed.ec == std::errc{} && parsed.ptr == end;
+}
+
+int toBinary(const std::string& textPath, const std::string& recordPath)
+{
+	std::ifstream in{ textPath };
+	if(!in)
+	{
+		std::cerr << "Can not open " << textPath << '\n';
+		return 1;
+	}
+
+	std::vector<CalcRecord> records{};
+	std::string line{};
+	for(std::uint64_t number{ 1 }; std::getline(in, line); ++number)
+	{
+		if(line.find_first_not_of(" \t\r") == std::string::npos)
+			continue;
+
+		CalcRecord record{};
+		if(!parseRecord(line, record))
+		{
+			std::cerr << textPath << ':' << number << ": expected \"a op b\"\n";
+			return 1;
+		}
+		records.push_back(record);
+	}
+
+	std::string error{};
+	RecordFileWriter writer{};
+	if(!writer.create(recordPath, recordMagic, records.size(), error))
+	{
+		std::cerr << error << '\n';
+		return 1;
+	}
+
+	std::copy(records.begin(), records.end(), writer.records());
+	if(!writer.commit(error))
+	{
+		std::cerr << error << '\n';
+		return 1;
+	}
+
+	return 0;
+}
+
+void appendNumber(std::string& output, double value)
+{
+	char digits[32]{};
+	output.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr);
+}
+
+int toText(const std::string& path, bool results)
+{
+	std::string error{};
+	MappedRecordFile file{};
+	if(!file.open(path, results ? resultMagic : recordMagic, error))
+	{
+		std::cerr << error << '\n';
+		return 1;
+	}
+
+	std::string output{};
+	for(std::uint64_t i{ 0 }; i < file.count(); ++i)
+	{
+		if(results)
+		{
+			appendNumber(output, file.results()[i]);
+		}
+		else
+		{
+			const CalcRecord& record{ file.records()[i] };
+			appendNumber(output, record.x);
+			output += ' ';
+			output += static_cast<char>(record.op);
+			output += ' ';
+			appendNumber(output, record.y);
+		}
+		output += '\n';
+
+		if(output.size() >= (1 << 20))
+		{
+			std::fwrite(output.data(), 1, output.size(), stdout);
+			output.clear();
+		}
+	}
+
+	std::fwrite(output.data(), 1, output.size(), stdout);
+	return 0;
+}
+
+int generate(std::uint64_t count, const std::string& recordPath)
+{
+	std::string error{};
+	RecordFileWriter writer{};
+	if(!writer.create(recordPath, recordMagic, count, error))
+	{
+		std::cerr << error << '\n';
+		return 1;
+	}
+
+	std::mt19937_64 mt{ 2024 };
+	std::uniform_real_distribution<double> value{ -1000.0, 1000.0 };
+	constexpr char symbols[]{ '+', '-', '*', '/' };
+	CalcRecord* records{ writer.records() };
+	for(std::uint64_t i{ 0 }; i < count; ++i)
+		records[i] = { value(mt), value(mt), static_cast<std::uint8_t>(symbols[mt() % 4]), {} };
+
+	if(!writer.commit(error))
+	{
+		std::cerr << error << '\n';
+		return 1;
+	}
+
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	const std::string mode{ argc > 1 ? argv[1] : "" };
+	if(mode == "--to-binary" && argc == 4)
+		return toBinary(argv[2], argv[3]);
+	if(mode == "--to-text" && argc == 3)
+		return toText(argv[2], false);
+	if(mode == "--results" && argc == 3)
+		return toText(argv[2], true);
+	if(mode == "--generate" && argc == 4)
+		return generate(std::stoull(argv[2]), argv[3]);
+
+	std::cerr << "Usage: convert --to-binary text records | --to-text records | --results results"
+		  << " | --generate count records\n";
+	return 1;
+}
@@ -0,0 +1,35 @@
+// Usage: main records results
+// Computes every record of a file made by convert and writes the result column, reporting throughput.
+
+// Build: g++ -std=c++17 -O2 main.cpp record_file.cpp
+
+#include "record_file.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/timer.h"
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[])
+{
+	if(argc != 3)
+	{
+		std::cerr << "Usage: main records results\n";
+		return 1;
+	}
+
+	Timer timer{};
+	std::uint64_t count{};
+	std::string error{};
+	if(!calculateRecordFile(argv[1], argv[2], count, error))
+	{
+		std::cerr << error << '\n';
+		return 1;
+	}
+	const double seconds{ timer.elapsed() };
+
+	const double bytes{ static_cast<double>(count) * (sizeof(CalcRecord) + sizeof(double)) };
+	std::cerr << count << " records, " << seconds << " s (" << (seconds > 0 ? count / seconds / 1e6 : 0.0)
+		  << " M records/s, " << (seconds > 0 ? bytes / seconds / 1e9 : 0.0) << " GB/s)\n";
+
+	return 0;
+}
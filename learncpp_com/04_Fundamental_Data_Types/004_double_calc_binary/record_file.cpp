@@ -0,0 +1,277 @@
+#include "record_file.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RECORD_X86 1
+#endif
+
+// Records per block: one block of input (96 KiB) and its results (32 KiB) stay in L2 while they are computed
+constexpr std::size_t blockRecords{ 4096 };
+
+std::string systemError(const std::string& what, const std::string& path)
+{
+	return what + " " + path + ": " + std::strerror(errno);
+}
+
+bool isRecordMagic(const char (&magic)[8])
+{
+	return std::memcmp(magic, recordMagic, sizeof(recordMagic)) == 0;
+}
+
+std::uint32_t itemSize(const char (&magic)[8])
+{
+	return isRecordMagic(magic) ? std::uint32_t{ sizeof(CalcRecord) } : std::uint32_t{ sizeof(double) };
+}
+
+void calculateRecordsScalar(const CalcRecord* records, double* results, std::size_t count)
+{
+	for(std::size_t i{ 0 }; i < count; ++i)
+		results[i] = calculateRecord(records[i].x, records[i].y, records[i].op);
+}
+
+#ifdef RECORD_X86
+
+// Four records are transposed into x and y vectors, all four operations are computed
+// and each lane picks its answer with a blend on the operator, so mixed operators never branch
+__attribute__((target("avx2")))
+void calculateRecordsAvx2(const CalcRecord* records, double* results, std::size_t count)
+{
+	const __m256i plus{ _mm256_set1_epi64x('+') };
+	const __m256i minus{ _mm256_set1_epi64x('-') };
+	const __m256i times{ _mm256_set1_epi64x('*') };
+	const __m256i slash{ _mm256_set1_epi64x('/') };
+	const __m256d nan{ _mm256_set1_pd(std::numeric_limits<double>::quiet_NaN()) };
+
+	std::size_t i{ 0 };
+	for(; i + 4 <= count; i += 4)
+	{
+		const CalcRecord* r{ records + i };
+
+		// (x0 y0 x2 y2) and (x1 y1 x3 y3) unpack to (x0 x1 x2 x3) and (y0 y1 y2 y3)
+		const __m256d even{ _mm256_set_m128d(_mm_loadu_pd(&r[2].x), _mm_loadu_pd(&r[0].x)) };
+		const __m256d odd{ _mm256_set_m128d(_mm_loadu_pd(&r[3].x), _mm_loadu_pd(&r[1].x)) };
+		const __m256d x{ _mm256_unpacklo_pd(even, odd) };
+		const __m256d y{ _mm256_unpackhi_pd(even, odd) };
+		const __m256i op{ _mm256_set_epi64x(r[3].op, r[2].op, r[1].op, r[0].op) };
+
+		__m256d result{ nan };
+		result = _mm256_blendv_pd(result, _mm256_add_pd(x, y), _mm256_castsi256_pd(_mm256_cmpeq_epi64(op, plus)));
+		result = _mm256_blendv_pd(result, _mm256_sub_pd(x, y), _mm256_castsi256_pd(_mm256_cmpeq_epi64(op, minus)));
+		result = _mm256_blendv_pd(result, _mm256_mul_pd(x, y), _mm256_castsi256_pd(_mm256_cmpeq_epi64(op, times)));
+		result = _mm256_blendv_pd(result, _mm256_div_pd(x, y), _mm256_castsi256_pd(_mm256_cmpeq_epi64(op, slash)));
+
+		_mm256_storeu_pd(results + i, result);
+	}
+
+	calculateRecordsScalar(records + i, results + i, count - i);
+}
+
+#endif
+
+void calculateRecords(const CalcRecord* records, double* results, std::size_t count)
+{
+#ifdef RECORD_X86
+	if(__builtin_cpu_supports("avx2"))
+		return calculateRecordsAvx2(records, results, count);
+#endif
+
+	calculateRecordsScalar(records, results, count);
+}
+
+MappedRecordFile::~MappedRecordFile()
+{
+	close();
+}
+
+void MappedRecordFile::close()
+{
+	if(m_mapping)
+		::munmap(m_mapping, m_mappingSize);
+
+	m_items = nullptr;
+	m_count = 0;
+	m_mapping = nullptr;
+	m_mappingSize = 0;
+}
+
+bool MappedRecordFile::open(const std::string& path, const char (&magic)[8], std::string& error)
+{
+	close();
+	error.clear();
+
+	const int fd{ ::open(path.c_str(), O_RDONLY) };
+	if(fd < 0)
+	{
+		error = systemError("Can not open", path);
+		return false;
+	}
+
+	struct stat status{};
+	if(::fstat(fd, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(RecordFileHeader)))
+	{
+		error = path + " is too small to be a record file";
+		::close(fd);
+		return false;
+	}
+
+	const auto size{ static_cast<std::size_t>(status.st_size) };
+	void* mapping{ ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) };
+	::close(fd);
+	if(mapping == MAP_FAILED)
+	{
+		error = systemError("Can not map", path);
+		return false;
+	}
+
+	RecordFileHeader header{};
+	std::memcpy(&header, mapping, sizeof(header));
+
+	if(std::memcmp(header.magic, magic, sizeof(header.magic)) != 0)
+		error = path + (isRecordMagic(magic) ? " is not a record file" : " is not a result file");
+	else if(header.version != recordVersion)
+		error = path + " has unsupported version " + std::to_string(header.version);
+	else if(header.byteOrderMark != recordByteOrderMark)
+		error = path + " was written on a machine with a different byte order";
+	else if(header.itemSize != itemSize(magic) || header.headerSize < sizeof(RecordFileHeader) || header.headerSize % 8 != 0
+		|| header.headerSize > size || (size - header.headerSize) / header.itemSize < header.count)
+		error = path + " has an inconsistent header";
+
+	if(!error.empty())
+	{
+		::munmap(mapping, size);
+		return false;
+	}
+
+	// read once from front to back
+	::madvise(mapping, size, MADV_SEQUENTIAL);
+
+	m_mapping = mapping;
+	m_mappingSize = size;
+	m_items = static_cast<const std::uint8_t*>(mapping) + header.headerSize;
+	m_count = header.count;
+
+	return true;
+}
+
+RecordFileWriter::~RecordFileWriter()
+{
+	if(m_mapping)
+	{
+		::munmap(m_mapping, m_mappingSize);
+		std::remove(m_temporaryPath.c_str());
+	}
+}
+
+bool RecordFileWriter::create(const std::string& path, const char (&magic)[8], std::uint64_t count, std::string& error)
+{
+	if(count > (std::numeric_limits<std::uint64_t>::max() - sizeof(RecordFileHeader)) / itemSize(magic)
+	   || count > static_cast<std::uint64_t>(std::numeric_limits<off_t>::max()) / itemSize(magic))
+	{
+		error = "Too many records for one file: " + std::to_string(count);
+		return false;
+	}
+
+	const std::uint64_t fileSize{ sizeof(RecordFileHeader) + count * itemSize(magic) };
+
+	// write to a temporary name and rename at the end, so readers never map a half-written file
+	m_path = path;
+	m_temporaryPath = path + ".tmp";
+	const int fd{ ::open(m_temporaryPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644) };
+	if(fd < 0)
+	{
+		error = systemError("Can not create", m_temporaryPath);
+		return false;
+	}
+
+	if(::ftruncate(fd, static_cast<off_t>(fileSize)) != 0)
+	{
+		error = systemError("Can not resize", m_temporaryPath);
+		::close(fd);
+		std::remove(m_temporaryPath.c_str());
+		return false;
+	}
+
+	void* mapping{ ::mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) };
+	::close(fd);
+	if(mapping == MAP_FAILED)
+	{
+		error = systemError("Can not map", m_temporaryPath);
+		std::remove(m_temporaryPath.c_str());
+		return false;
+	}
+
+	RecordFileHeader header{};
+	std::memcpy(header.magic, magic, sizeof(header.magic));
+	header.version = recordVersion;
+	header.byteOrderMark = recordByteOrderMark;
+	header.headerSize = sizeof(RecordFileHeader);
+	header.itemSize = itemSize(magic);
+	header.count = count;
+	std::memcpy(mapping, &header, sizeof(header));
+
+	m_mapping = mapping;
+	m_mappingSize = fileSize;
+	m_items = static_cast<std::uint8_t*>(mapping) + sizeof(RecordFileHeader);
+
+	return true;
+}
+
+bool RecordFileWriter::commit(std::string& error)
+{
+	const bool synced{ ::msync(m_mapping, m_mappingSize, MS_SYNC) == 0 };
+	::munmap(m_mapping, m_mappingSize);
+	m_mapping = nullptr;
+	m_items = nullptr;
+	if(!synced)
+	{
+		error = systemError("Can not write", m_temporaryPath);
+		std::remove(m_temporaryPath.c_str());
+		return false;
+	}
+
+	if(std::rename(m_temporaryPath.c_str(), m_path.c_str()) != 0)
+	{
+		error = systemError("Can not rename to", m_path);
+		std::remove(m_temporaryPath.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+bool calculateRecordFile(const std::string& recordPath, const std::string& resultPath, std::uint64_t& count,
+			 std::string& error)
+{
+	MappedRecordFile records{};
+	if(!records.open(recordPath, recordMagic, error))
+		return false;
+
+	count = records.count();
+	RecordFileWriter results{};
+	if(!results.create(resultPath, resultMagic, count, error))
+		return false;
+
+	const CalcRecord* in{ records.records() };
+	double* out{ results.results() };
+	for(std::uint64_t first{ 0 }; first < count; first += blockRecords)
+	{
+		const auto size{ static_cast<std::size_t>(std::min<std::uint64_t>(blockRecords, count - first)) };
+		calculateRecords(in + first, out + first, size);
+	}
+
+	return results.commit(error);
+}
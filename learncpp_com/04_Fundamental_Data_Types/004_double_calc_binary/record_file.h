@@ -0,0 +1,117 @@
+#ifndef RECORD_FILE_H
+#define RECORD_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+	// Binary input and output for 002_double_calc.cpp.
+	// A record file is a 64-byte header followed by fixed 24-byte (double, double, op) records;
+	// a result file is the same header followed by one double per record, in record order.
+	// Integers and doubles are stored in the byte order of the machine that wrote the file; a reader rejects a mismatch.
+
+	inline constexpr char recordMagic[8]{ 'C', 'A', 'L', 'C', 'R', 'E', 'C', 'S' };
+	inline constexpr char resultMagic[8]{ 'C', 'A', 'L', 'C', 'R', 'S', 'L', 'T' };
+	inline constexpr std::uint32_t recordVersion{ 1 };
+	inline constexpr std::uint32_t recordByteOrderMark{ 0x0102'0304 };
+
+	struct CalcRecord
+	{
+		double x;
+		double y;
+		std::uint8_t op;                // '+', '-', '*' or '/'
+		std::uint8_t reserved[7];
+	};
+
+	static_assert(sizeof(CalcRecord) == 24);
+
+	struct RecordFileHeader
+	{
+		char magic[8];                  // recordMagic or resultMagic
+		std::uint32_t version;
+		std::uint32_t byteOrderMark;
+		std::uint32_t headerSize;       // offset of the first record or result
+		std::uint32_t itemSize;         // sizeof(CalcRecord) or sizeof(double)
+		std::uint64_t count;
+		std::uint8_t reserved[32];
+	};
+
+	static_assert(sizeof(RecordFileHeader) == 64);
+
+	// The answer 002_double_calc.cpp prints; NaN for an unknown operator, where it printed nothing
+	inline double calculateRecord(double x, double y, std::uint8_t op)
+	{
+		switch(op)
+		{
+			case '+':   return x + y;
+			case '-':   return x - y;
+			case '*':   return x * y;
+			case '/':   return x / y;
+		}
+
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+
+	// results[i] = calculateRecord(records[i]) for every i; 4 records at a time with AVX2 when the CPU has it
+	void calculateRecords(const CalcRecord* records, double* results, std::size_t count);
+
+	// Read-only mapping of a record or result file; which one is chosen by the expected magic
+	class MappedRecordFile
+	{
+	private:
+		const std::uint8_t* m_items{ nullptr };
+		std::uint64_t m_count{ 0 };
+		void* m_mapping{ nullptr };
+		std::size_t m_mappingSize{ 0 };
+
+	public:
+		MappedRecordFile() = default;
+		~MappedRecordFile();
+
+		MappedRecordFile(const MappedRecordFile&) = delete;
+		MappedRecordFile& operator=(const MappedRecordFile&) = delete;
+
+		bool open(const std::string& path, const char (&magic)[8], std::string& error);
+		void close();
+
+		bool isOpen() const { return m_mapping != nullptr; }
+		std::uint64_t count() const { return m_count; }
+
+		const CalcRecord* records() const { return reinterpret_cast<const CalcRecord*>(m_items); }
+		const double* results() const { return reinterpret_cast<const double*>(m_items); }
+	};
+
+	// Writes a record or result file: create() makes a file with the given magic and room for count items
+	// and maps it writable, the caller fills the items through records() or results(), and commit() publishes it.
+	// The file is written under a temporary name and renamed once complete; it is removed if never committed.
+	class RecordFileWriter
+	{
+	private:
+		std::string m_path{};
+		std::string m_temporaryPath{};
+		std::uint8_t* m_items{ nullptr };
+		void* m_mapping{ nullptr };
+		std::size_t m_mappingSize{ 0 };
+
+	public:
+		RecordFileWriter() = default;
+		~RecordFileWriter();
+
+		RecordFileWriter(const RecordFileWriter&) = delete;
+		RecordFileWriter& operator=(const RecordFileWriter&) = delete;
+
+		bool create(const std::string& path, const char (&magic)[8], std::uint64_t count, std::string& error);
+
+		// Syncs, unmaps and renames into place
+		bool commit(std::string& error);
+
+		CalcRecord* records() { return reinterpret_cast<CalcRecord*>(m_items); }
+		double* results() { return reinterpret_cast<double*>(m_items); }
+	};
+
+	// Maps recordPath, computes every record in cache-sized blocks and writes the result column to resultPath
+	bool calculateRecordFile(const std::string& recordPath, const std::string& resultPath, std::uint64_t& count,
+				 std::string& error);
+
+#endif
@@ -1,31 +1,23 @@
-#include <iostream>
-#include <cstdint>     // for std::int_fast64_t
-
-std::int_fast64_t powint(int base, int exp)
-{
-	std::int_fast64_t result{ 1 };
-	while (exp)
-	{
-		if (exp & 1)
-			result *= base;
-		exp >>= 1;
-		base *= base;
-	}
+// Build: g++ -std=c++17 -O2 000_exponentiation_by_squaring.cpp
 
-	return result;
-}
+#include "002_pow/powint.h"   // powint() and the overflow-checked powintChecked()
+#include <cstdint>
+#include <iostream>
 
 int main()
 {
 	std::cout << "Enter the base: ";
-	int base{};
+	std::int64_t base{};
 	std::cin >> base;
 
 	std::cout << "Enter a non-negative exponent: ";
 	int exp{};
 	std::cin >> exp;
 
-	std::cout << powint(base, exp);
+	const CheckedPower power{ powintChecked(base, exp) };
+	std::cout << power.value;
+	if(power.saturated)
+		std::cout << " (saturated: the result does not fit in 64 bits)";
 
 	return 0;
 }
@@ -0,0 +1,186 @@
+// Check powmod against a plain % implementation and compare their speed,
+// then compare powint with powintChecked, and the scalar powint loop with every powintBatch kernel the CPU supports.
+
+// Build: g++ -std=c++17 -O2 benchmark.cpp powint_batch.cpp
+
+#include "powint.h"
+#include "powint_batch.h"
+#include "powmod.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/timer.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// The reference: one 128-bit % per multiplication
+std::uint64_t powmodDivide(std::uint64_t base, std::uint64_t exp, std::uint64_t mod)
+{
+	std::uint64_t result{ 1 % mod };
+	base %= mod;
+	while(exp)
+	{
+		if(exp & 1)
+			result = static_cast<std::uint64_t>(static_cast<unsigned __int128>(result) * base % mod);
+		exp >>= 1;
+		base = static_cast<std::uint64_t>(static_cast<unsigned __int128>(base) * base % mod);
+	}
+
+	return result;
+}
+
+std::uint32_t powmodDivide32(std::uint32_t base, std::uint32_t exp, std::uint32_t mod)
+{
+	std::uint64_t result{ 1 % mod };
+	std::uint64_t square{ base % mod };
+	while(exp)
+	{
+		if(exp & 1)
+			result = result * square % mod;
+		exp >>= 1;
+		square = square * square % mod;
+	}
+
+	return static_cast<std::uint32_t>(result);
+}
+
+struct Query
+{
+	std::uint64_t base{};
+	std::uint64_t exp{};
+	std::uint64_t mod{};
+};
+
+int main()
+{
+	std::mt19937_64 mt{ 99 };
+	constexpr int count{ 200'000 };
+
+	std::vector<Query> queries(count);
+	for(auto& query : queries)
+		query = { mt(), mt(), (mt() >> (mt() % 63)) | 1 };
+	for(int i{ 0 }; i < count / 4; ++i)
+		queries[static_cast<std::size_t>(i)].mod &= ~std::uint64_t{ 1 };      // some even moduli too
+	queries[0].mod = 1;
+	queries[1].mod = ~std::uint64_t{ 0 };
+
+	int mismatches{ 0 };
+	for(const auto& [base, exp, mod] : queries)
+	{
+		if(mod == 0)
+			continue;
+		if(powmod(base, exp, mod) != powmodDivide(base, exp, mod))
+			++mismatches;
+		const auto mod32{ static_cast<std::uint32_t>(mod) };
+		if(mod32 != 0 && powmod(static_cast<std::uint32_t>(base), static_cast<std::uint32_t>(exp), mod32)
+				 != powmodDivide32(static_cast<std::uint32_t>(base), static_cast<std::uint32_t>(exp), mod32))
+			++mismatches;
+	}
+	std::cout << "powmod mismatches: " << mismatches << '\n';
+
+	// odd 64-bit moduli near 2^64, the Miller-Rabin case
+	for(auto& query : queries)
+		query.mod = mt() | 1 | (std::uint64_t{ 1 } << 63);
+
+	std::uint64_t checksum{ 0 };
+	Timer timer{};
+	for(const auto& [base, exp, mod] : queries)
+		checksum += powmodDivide(base, exp, mod);
+	const double divideNs{ timer.elapsed() * 1e9 / count };
+
+	timer.reset();
+	for(const auto& [base, exp, mod] : queries)
+		checksum -= powmod(base, exp, mod);
+	const double montgomeryNs{ timer.elapsed() * 1e9 / count };
+
+	// one modulus, many powers: the Montgomery setup is paid once
+	const Montgomery64 shared{ queries[0].mod };
+	timer.reset();
+	for(const auto& query : queries)
+		checksum += shared.power(shared.toMontgomery(query.base), query.exp);
+	const double sharedNs{ timer.elapsed() * 1e9 / count };
+
+	std::uint64_t checksum32{ 0 };
+	timer.reset();
+	for(const auto& [base, exp, mod] : queries)
+		checksum32 += powmodDivide32(static_cast<std::uint32_t>(base), static_cast<std::uint32_t>(exp), static_cast<std::uint32_t>(mod));
+	const double divide32Ns{ timer.elapsed() * 1e9 / count };
+
+	timer.reset();
+	for(const auto& [base, exp, mod] : queries)
+		checksum32 -= powmod(static_cast<std::uint32_t>(base), static_cast<std::uint32_t>(exp), static_cast<std::uint32_t>(mod));
+	const double montgomery32Ns{ timer.elapsed() * 1e9 / count };
+
+	timer.reset();
+	for(const auto& [base, exp, mod] : queries)
+		checksum32 += Barrett32{ static_cast<std::uint32_t>(mod) & ~1u }.power(static_cast<std::uint32_t>(base), static_cast<std::uint32_t>(exp));
+	const double barrett32Ns{ timer.elapsed() * 1e9 / count };
+
+	std::cout << "(checksums " << checksum << ' ' << checksum32 << ")\n"
+		  << "64-bit powmod, ns per call: % " << divideNs << ", Montgomery " << montgomeryNs
+		  << ", Montgomery with a shared modulus " << sharedNs << '\n'
+		  << "32-bit powmod, ns per call: % " << divide32Ns << ", Montgomery " << montgomery32Ns
+		  << ", Barrett (even moduli) " << barrett32Ns << '\n';
+
+	int checkedMismatches{ 0 };
+	int saturated{ 0 };
+	timer.reset();
+	for(std::int64_t base{ -40 }; base <= 40; ++base)
+	{
+		for(int exp{ 0 }; exp < 70; ++exp)
+		{
+			const CheckedPower checked{ powintChecked(base, exp) };
+			saturated += checked.saturated ? 1 : 0;
+			if(!checked.saturated && checked.value != powint(base, exp))
+				++checkedMismatches;
+		}
+	}
+	std::cout << "powintChecked: " << saturated << " saturated, " << checkedMismatches << " mismatches with powint\n";
+
+	constexpr std::size_t pairCount{ 1 << 22 };
+	std::vector<std::int64_t> bases(pairCount);
+	std::vector<int> exps(pairCount);
+	for(std::size_t i{ 0 }; i < pairCount; ++i)
+	{
+		bases[i] = static_cast<std::int64_t>(mt());
+		exps[i] = static_cast<int>(mt() % 64) - 2;      // mostly short exponents, a few negative ones
+	}
+	exps[5] = 0x7FFF'FFFF;
+
+	std::vector<std::int64_t> scalarPowers(pairCount);
+	timer.reset();
+	for(std::size_t i{ 0 }; i < pairCount; ++i)
+		scalarPowers[i] = powint(bases[i], exps[i]);
+	const double scalarPowNs{ timer.elapsed() * 1e9 / pairCount };
+
+	std::cout << "powint over " << pairCount << " pairs, ns per pair: scalar loop " << scalarPowNs << '\n';
+
+	// odd counts leave a tail for the kernels' scalar loop
+	bool differ{ false };
+	std::vector<std::int64_t> batchPowers(pairCount);
+	for(PowintKernel kernel : { PowintKernel::scalar, PowintKernel::sse2, PowintKernel::avx2 })
+	{
+		if(static_cast<int>(kernel) > static_cast<int>(bestPowintKernel()))
+			continue;
+
+		for(std::size_t tail{ 0 }; tail < 4; ++tail)
+		{
+			std::fill(batchPowers.begin(), batchPowers.end(), 0);
+			powintBatch(bases.data(), exps.data(), batchPowers.data(), pairCount - tail, kernel);
+			if(!std::equal(batchPowers.begin(), batchPowers.end() - static_cast<std::ptrdiff_t>(tail), scalarPowers.begin()))
+				differ = true;
+		}
+
+		timer.reset();
+		powintBatch(bases.data(), exps.data(), batchPowers.data(), pairCount, kernel);
+		const double batchPowNs{ timer.elapsed() * 1e9 / pairCount };
+
+		const bool identical{ batchPowers == scalarPowers };
+		differ = differ || !identical;
+		std::cout << "  powintBatch " << kernelName(kernel) << ' ' << batchPowNs
+			  << (identical ? " (identical results)" : " (RESULTS DIFFER)") << '\n';
+	}
+
+	return differ ? 1 : 0;
+}
@@ -0,0 +1,45 @@
+// Ask for a base, an exponent and a modulus. Print the exact power (or report that it saturates)
+// and the power modulo the modulus.
+
+// Build: g++ -std=c++17 -O2 main.cpp
+
+#include "powint.h"
+#include "powmod.h"
+#include <cstdint>
+#include <iostream>
+
+int main()
+{
+	std::cout << "Enter the base: ";
+	std::int64_t base{};
+	std::cin >> base;
+
+	std::cout << "Enter a non-negative exponent: ";
+	int exp{};
+	std::cin >> exp;
+
+	std::cout << "Enter a positive modulus: ";
+	std::uint64_t mod{};
+	std::cin >> mod;
+
+	const CheckedPower power{ powintChecked(base, exp) };
+	if(power.saturated)
+		std::cout << "base^exp does not fit in 64 bits (saturated to " << power.value << ")\n";
+	else
+		std::cout << "base^exp = " << power.value << '\n';
+
+	if(mod == 0 || exp < 0)
+	{
+		return 0;
+	}
+
+	// reduce a negative base into [0, mod) first
+	const auto magnitude{ base < 0 ? 0 - static_cast<std::uint64_t>(base) : static_cast<std::uint64_t>(base) };
+	std::uint64_t residue{ magnitude % mod };
+	if(base < 0 && residue != 0)
+		residue = mod - residue;
+
+	std::cout << "base^exp mod " << mod << " = " << powmod(residue, static_cast<std::uint64_t>(exp), mod) << '\n';
+
+	return 0;
+}
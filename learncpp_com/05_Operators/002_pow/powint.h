@@ -0,0 +1,63 @@
+#ifndef POWINT_H
+#define POWINT_H
+
+#include <cstdint>
+#include <limits>
+
+// Integer power by squaring without undefined behavior.
+// A negative exponent gives x^0 = 1 (the exponent is treated as 0); the old loop in
+// 000_exponentiation_by_squaring.cpp never terminated for one, so this case is newly defined.
+
+// Wraps around modulo 2^64 (two's complement) when the result does not fit
+inline std::int64_t powint(std::int64_t base, int exp)
+{
+	std::uint64_t result{ 1 };
+	auto square{ static_cast<std::uint64_t>(base) };
+	auto bits{ static_cast<unsigned>(exp < 0 ? 0 : exp) };
+	while(bits)
+	{
+		if(bits & 1)
+			result *= square;
+		bits >>= 1;
+		square *= square;
+	}
+
+	return static_cast<std::int64_t>(result);
+}
+
+struct CheckedPower
+{
+	std::int64_t value{};
+	bool saturated{};       // the true result did not fit, value is clamped to the int64 limit of its sign
+};
+
+// Saturates to INT64_MAX or INT64_MIN when the true result does not fit
+inline CheckedPower powintChecked(std::int64_t base, int exp)
+{
+	auto bits{ static_cast<unsigned>(exp < 0 ? 0 : exp) };
+	const bool negative{ base < 0 && (bits & 1) };
+
+	std::int64_t result{ 1 };
+	std::int64_t square{ base };
+	while(bits)
+	{
+		if(bits & 1)
+		{
+			if(__builtin_mul_overflow(result, square, &result))
+				break;
+		}
+
+		bits >>= 1;
+		if(bits && __builtin_mul_overflow(square, square, &square))
+			break;      // this square is still needed, so the final result overflows as well
+	}
+
+	if(bits == 0)
+	{
+		return { result, false };
+	}
+
+	return { negative ? std::numeric_limits<std::int64_t>::min() : std::numeric_limits<std::int64_t>::max(), true };
+}
+
+#endif
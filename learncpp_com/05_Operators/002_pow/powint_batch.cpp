@@ -0,0 +1,137 @@
+#include "powint_batch.h"
+#include "powint.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define POWINT_X86 1
+#endif
+
+void powintScalar(const std::int64_t* bases, const int* exps, std::int64_t* out, std::size_t count)
+{
+	for(std::size_t i{ 0 }; i < count; ++i)
+		out[i] = powint(bases[i], exps[i]);
+}
+
+#ifdef POWINT_X86
+
+// Neither SSE2 nor AVX2 has a 64-bit multiply, so it is built from three 32x32->64 multiplies:
+// a * b mod 2^64 = lo(a) * lo(b) + ((hi(a) * lo(b) + lo(a) * hi(b)) << 32)
+
+__attribute__((target("sse2")))
+__m128i multiply64(__m128i a, __m128i b)
+{
+	const __m128i low{ _mm_mul_epu32(a, b) };
+	const __m128i cross{ _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), b), _mm_mul_epu32(a, _mm_srli_epi64(b, 32))) };
+
+	return _mm_add_epi64(low, _mm_slli_epi64(cross, 32));
+}
+
+__attribute__((target("avx2")))
+__m256i multiply64(__m256i a, __m256i b)
+{
+	const __m256i low{ _mm256_mul_epu32(a, b) };
+	const __m256i cross{ _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+					      _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32))) };
+
+	return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+}
+
+// Square-and-multiply on all lanes at once. The loop runs for the longest exponent in the group;
+// a lane whose exponent bit is 0 (including every lane that has already finished) keeps its result.
+
+__attribute__((target("sse2")))
+void powintSse2(const std::int64_t* bases, const int* exps, std::int64_t* out, std::size_t count)
+{
+	const __m128i one{ _mm_set1_epi64x(1) };
+	const __m128i zero{ _mm_setzero_si128() };
+
+	std::size_t i{ 0 };
+	for(; i + 2 <= count; i += 2)
+	{
+		__m128i square{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(bases + i)) };
+		__m128i exp{ _mm_set_epi64x(exps[i + 1] < 0 ? 0 : exps[i + 1], exps[i] < 0 ? 0 : exps[i]) };
+		__m128i result{ one };
+
+		// SSE2 has no 64-bit compare, but exp & 1 is 0 or 1, so 0 - (exp & 1) is already a full lane mask
+		while(_mm_movemask_epi8(_mm_cmpeq_epi32(exp, zero)) != 0xFFFF)
+		{
+			const __m128i mask{ _mm_sub_epi64(zero, _mm_and_si128(exp, one)) };
+			result = _mm_or_si128(_mm_and_si128(mask, multiply64(result, square)), _mm_andnot_si128(mask, result));
+			exp = _mm_srli_epi64(exp, 1);
+			square = multiply64(square, square);
+		}
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), result);
+	}
+
+	powintScalar(bases + i, exps + i, out + i, count - i);
+}
+
+__attribute__((target("avx2")))
+void powintAvx2(const std::int64_t* bases, const int* exps, std::int64_t* out, std::size_t count)
+{
+	const __m256i one{ _mm256_set1_epi64x(1) };
+	const __m128i zero32{ _mm_setzero_si128() };
+
+	std::size_t i{ 0 };
+	for(; i + 4 <= count; i += 4)
+	{
+		__m256i square{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bases + i)) };
+		const __m128i exps32{ _mm_max_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(exps + i)), zero32) };
+		__m256i exp{ _mm256_cvtepi32_epi64(exps32) };
+		__m256i result{ one };
+
+		while(!_mm256_testz_si256(exp, exp))
+		{
+			const __m256i mask{ _mm256_cmpeq_epi64(_mm256_and_si256(exp, one), one) };
+			result = _mm256_blendv_epi8(result, multiply64(result, square), mask);
+			exp = _mm256_srli_epi64(exp, 1);
+			square = multiply64(square, square);
+		}
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), result);
+	}
+
+	powintScalar(bases + i, exps + i, out + i, count - i);
+}
+
+#endif
+
+PowintKernel bestPowintKernel()
+{
+#ifdef POWINT_X86
+	static const PowintKernel best{ __builtin_cpu_supports("avx2")   ? PowintKernel::avx2
+					: __builtin_cpu_supports("sse2") ? PowintKernel::sse2
+									 : PowintKernel::scalar };
+	return best;
+#else
+	return PowintKernel::scalar;
+#endif
+}
+
+const char* kernelName(PowintKernel kernel)
+{
+	switch(kernel)
+	{
+		case PowintKernel::scalar:  return "scalar";
+		case PowintKernel::sse2:    return "sse2";
+		case PowintKernel::avx2:    return "avx2";
+	}
+
+	return "???";
+}
+
+void powintBatch(const std::int64_t* bases, const int* exps, std::int64_t* out, std::size_t count, PowintKernel kernel)
+{
+#ifdef POWINT_X86
+	if(kernel == PowintKernel::avx2)
+		return powintAvx2(bases, exps, out, count);
+	if(kernel == PowintKernel::sse2)
+		return powintSse2(bases, exps, out, count);
+#endif
+
+	powintScalar(bases, exps, out, count);
+}
@@ -0,0 +1,24 @@
+#ifndef POWINT_BATCH_H
+#define POWINT_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+
+	// The SSE2 kernel runs 2 lanes and the AVX2 kernel 4; both are x86 only. bestPowintKernel() is the fastest
+	// one the CPU supports; passing a kernel the CPU does not support is undefined.
+	enum class PowintKernel
+	{
+		scalar,
+		sse2,
+		avx2,
+	};
+
+	PowintKernel bestPowintKernel();
+	const char* kernelName(PowintKernel kernel);
+
+	// out[i] = powint(bases[i], exps[i]) for every i, bit for bit the same as the scalar powint
+	// (wrapping modulo 2^64, negative exponents treated as 0) whichever kernel runs it.
+	void powintBatch(const std::int64_t* bases, const int* exps, std::int64_t* out, std::size_t count,
+			 PowintKernel kernel = bestPowintKernel());
+
+#endif
@@ -0,0 +1,204 @@
+#ifndef POWMOD_H
+#define POWMOD_H
+
+#include <cstdint>
+
+// Modular exponentiation without a hardware division per multiplication.
+// Odd moduli use Montgomery multiplication; even 32-bit moduli use Barrett reduction.
+// Even 64-bit moduli fall back to 128-bit %, since Barrett for them would need 192-bit products.
+// unsigned __int128 is a GCC/Clang extension.
+
+// Montgomery form for one odd 64-bit modulus: x is stored as x * 2^64 mod n.
+// Build one per modulus and reuse it when many powers share that modulus (e.g. Miller-Rabin rounds).
+class Montgomery64
+{
+private:
+	std::uint64_t m_n{};
+	std::uint64_t m_inverse{};      // n^-1 mod 2^64
+	std::uint64_t m_r2{};           // 2^128 mod n
+	std::uint64_t m_one{};          // 2^64 mod n, the Montgomery form of 1
+
+public:
+	explicit Montgomery64(std::uint64_t n)
+		: m_n{ n }
+	{
+		// Newton's iteration doubles the number of correct low bits each step: 1 (n is odd) -> 64 bits
+		m_inverse = n;
+		for(int i{ 0 }; i < 6; ++i)
+			m_inverse *= 2 - n * m_inverse;
+
+		m_one = (0 - n) % n;
+		m_r2 = static_cast<std::uint64_t>(static_cast<unsigned __int128>(m_one) * m_one % n);
+	}
+
+	std::uint64_t modulus() const { return m_n; }
+	std::uint64_t one() const { return m_one; }
+
+	// t * 2^-64 mod n, for t < n * 2^64
+	std::uint64_t reduce(unsigned __int128 t) const
+	{
+		const auto low{ static_cast<std::uint64_t>(t) };
+		const auto high{ static_cast<std::uint64_t>(t >> 64) };
+		const std::uint64_t m{ low * m_inverse };
+		const auto mn{ static_cast<std::uint64_t>((static_cast<unsigned __int128>(m) * m_n) >> 64) };
+
+		// the low halves of t and m * n are equal, so only the high halves need subtracting
+		return high >= mn ? high - mn : high - mn + m_n;
+	}
+
+	std::uint64_t multiply(std::uint64_t a, std::uint64_t b) const
+	{
+		return reduce(static_cast<unsigned __int128>(a) * b);
+	}
+
+	std::uint64_t toMontgomery(std::uint64_t x) const { return multiply(x % m_n, m_r2); }
+	std::uint64_t fromMontgomery(std::uint64_t x) const { return reduce(x); }
+
+	// Both base and result in Montgomery form
+	std::uint64_t power(std::uint64_t base, std::uint64_t exp) const
+	{
+		std::uint64_t result{ m_one };
+		while(exp)
+		{
+			if(exp & 1)
+				result = multiply(result, base);
+			exp >>= 1;
+			base = multiply(base, base);
+		}
+
+		return result;
+	}
+};
+
+// Same as Montgomery64 for odd 32-bit moduli, with 64-bit intermediates
+class Montgomery32
+{
+private:
+	std::uint32_t m_n{};
+	std::uint32_t m_inverse{};
+	std::uint32_t m_r2{};
+	std::uint32_t m_one{};
+
+public:
+	explicit Montgomery32(std::uint32_t n)
+		: m_n{ n }
+	{
+		m_inverse = n;
+		for(int i{ 0 }; i < 5; ++i)
+			m_inverse *= 2 - n * m_inverse;
+
+		m_one = static_cast<std::uint32_t>((std::uint64_t{ 1 } << 32) % n);
+		m_r2 = static_cast<std::uint32_t>(std::uint64_t{ m_one } * m_one % n);
+	}
+
+	std::uint32_t reduce(std::uint64_t t) const
+	{
+		const auto low{ static_cast<std::uint32_t>(t) };
+		const auto high{ static_cast<std::uint32_t>(t >> 32) };
+		const std::uint32_t m{ low * m_inverse };
+		const auto mn{ static_cast<std::uint32_t>((std::uint64_t{ m } * m_n) >> 32) };
+
+		return high >= mn ? high - mn : high - mn + m_n;
+	}
+
+	std::uint32_t multiply(std::uint32_t a, std::uint32_t b) const
+	{
+		return reduce(std::uint64_t{ a } * b);
+	}
+
+	std::uint32_t toMontgomery(std::uint32_t x) const { return multiply(x % m_n, m_r2); }
+	std::uint32_t fromMontgomery(std::uint32_t x) const { return reduce(x); }
+
+	std::uint32_t power(std::uint32_t base, std::uint32_t exp) const
+	{
+		std::uint32_t result{ m_one };
+		while(exp)
+		{
+			if(exp & 1)
+				result = multiply(result, base);
+			exp >>= 1;
+			base = multiply(base, base);
+		}
+
+		return result;
+	}
+};
+
+// Barrett reduction for any 32-bit modulus: x mod n from one high multiply and a small correction
+class Barrett32
+{
+private:
+	std::uint32_t m_n{};
+	std::uint64_t m_factor{};       // floor((2^64 - 1) / n)
+
+public:
+	explicit Barrett32(std::uint32_t n)
+		: m_n{ n }, m_factor{ ~std::uint64_t{ 0 } / n }
+	{
+	}
+
+	std::uint32_t reduce(std::uint64_t x) const
+	{
+		const auto quotient{ static_cast<std::uint64_t>((static_cast<unsigned __int128>(x) * m_factor) >> 64) };
+		std::uint64_t remainder{ x - quotient * m_n };
+		while(remainder >= m_n)             // the quotient estimate is at most two too small
+			remainder -= m_n;
+
+		return static_cast<std::uint32_t>(remainder);
+	}
+
+	std::uint32_t multiply(std::uint32_t a, std::uint32_t b) const
+	{
+		return reduce(std::uint64_t{ a } * b);
+	}
+
+	std::uint32_t power(std::uint32_t base, std::uint32_t exp) const
+	{
+		std::uint32_t result{ reduce(1) };
+		base = reduce(base);
+		while(exp)
+		{
+			if(exp & 1)
+				result = multiply(result, base);
+			exp >>= 1;
+			base = multiply(base, base);
+		}
+
+		return result;
+	}
+};
+
+// base^exp mod mod. mod must not be 0. Pass explicitly sized arguments: plain int literals are ambiguous.
+inline std::uint32_t powmod(std::uint32_t base, std::uint32_t exp, std::uint32_t mod)
+{
+	if(mod & 1)
+	{
+		const Montgomery32 montgomery{ mod };
+		return montgomery.fromMontgomery(montgomery.power(montgomery.toMontgomery(base), exp));
+	}
+
+	return Barrett32{ mod }.power(base, exp);
+}
+
+inline std::uint64_t powmod(std::uint64_t base, std::uint64_t exp, std::uint64_t mod)
+{
+	if(mod & 1)
+	{
+		const Montgomery64 montgomery{ mod };
+		return montgomery.fromMontgomery(montgomery.power(montgomery.toMontgomery(base), exp));
+	}
+
+	std::uint64_t result{ 1 % mod };
+	base %= mod;
+	while(exp)
+	{
+		if(exp & 1)
+			result = static_cast<std::uint64_t>(static_cast<unsigned __int128>(result) * base % mod);
+		exp >>= 1;
+		base = static_cast<std::uint64_t>(static_cast<unsigned __int128>(base) * base % mod);
+	}
+
+	return result;
+}
+
+#endif
@@ -0,0 +1,138 @@
+// Deinterleave and interleave random 4K RGBA frames with every kernel the CPU supports,
+// check them against the scalar mask-and-shift path, and report GB/s of packed pixels.
+// Then run whole frames in tiles on 1, 2, 4, ... threads.
+
+// Build: g++ -std=c++17 -O2 -pthread benchmark.cpp pixels.cpp ../../08_Control_Flow_and_Error_Handling/008_primality/thread_pool.cpp
+
+#include "pixels.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/thread_pool.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/timer.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+constexpr std::size_t frameWidth{ 3840 };
+constexpr std::size_t frameHeight{ 2160 };
+constexpr std::size_t frameSize{ frameWidth * frameHeight };
+constexpr int repetitions{ 20 };
+
+struct PlanarFrame
+{
+	std::vector<std::uint8_t> red = std::vector<std::uint8_t>(frameSize);
+	std::vector<std::uint8_t> green = std::vector<std::uint8_t>(frameSize);
+	std::vector<std::uint8_t> blue = std::vector<std::uint8_t>(frameSize);
+	std::vector<std::uint8_t> alpha = std::vector<std::uint8_t>(frameSize);
+
+	Planes planes() { return { red.data(), green.data(), blue.data(), alpha.data() }; }
+	ConstPlanes constPlanes() const { return { red.data(), green.data(), blue.data(), alpha.data() }; }
+
+	bool operator==(const PlanarFrame& other) const
+	{
+		return red == other.red && green == other.green && blue == other.blue && alpha == other.alpha;
+	}
+};
+
+bool isSupported(PixelKernel kernel)
+{
+	return static_cast<int>(kernel) <= static_cast<int>(bestPixelKernel());
+}
+
+double gigabytesPerSecond(double seconds)
+{
+	return seconds > 0 ? static_cast<double>(frameSize * sizeof(std::uint32_t)) * repetitions / seconds / 1e9 : 0.0;
+}
+
+int main()
+{
+	std::mt19937 mt{ 2024 };
+	std::vector<std::uint32_t> frame(frameSize);
+	for(std::uint32_t& pixel : frame)
+		pixel = static_cast<std::uint32_t>(mt());
+
+	// odd counts exercise the scalar tails
+	int failures{ 0 };
+	for(std::size_t count : { 0, 1, 15, 17, 31, 33, 1000 })
+	{
+		for(PixelKernel kernel : { PixelKernel::scalar, PixelKernel::ssse3, PixelKernel::avx2 })
+		{
+			if(!isSupported(kernel))
+				continue;
+
+			std::vector<std::uint8_t> bytes(4 * count + 4, 0xEE);
+			const Planes planes{ bytes.data(), bytes.data() + count + 1, bytes.data() + 2 * count + 2, bytes.data() + 3 * count + 3 };
+			deinterleave(frame.data(), count, planes, kernel);
+
+			std::vector<std::uint32_t> packed(count + 1, 0xEEEEEEEE);
+			interleave({ planes.red, planes.green, planes.blue, planes.alpha }, count, packed.data(), kernel);
+			for(std::size_t i{ 0 }; i < count; ++i)
+			{
+				const std::uint32_t pixel{ frame[i] };
+				const bool good{ planes.red[i] == pixel >> 24 && planes.green[i] == (pixel >> 16 & 0xFF)
+						 && planes.blue[i] == (pixel >> 8 & 0xFF) && planes.alpha[i] == (pixel & 0xFF)
+						 && packed[i] == pixel };
+				failures += good ? 0 : 1;
+			}
+			failures += (planes.red[count] == 0xEE && packed[count] == 0xEEEEEEEE) ? 0 : 1;      // nothing written past the end
+		}
+	}
+
+	PlanarFrame reference{};
+	deinterleave(frame.data(), frameSize, reference.planes(), PixelKernel::scalar);
+
+	std::cout << "Frame " << frameWidth << 'x' << frameHeight << ", " << frameSize * sizeof(std::uint32_t) / (1 << 20)
+		  << " MiB packed, " << repetitions << " repetitions\n\n";
+
+	PlanarFrame planar{};
+	std::vector<std::uint32_t> packed(frameSize);
+	for(PixelKernel kernel : { PixelKernel::scalar, PixelKernel::ssse3, PixelKernel::avx2 })
+	{
+		if(!isSupported(kernel))
+			continue;
+
+		Timer timer{};
+		for(int r{ 0 }; r < repetitions; ++r)
+			deinterleave(frame.data(), frameSize, planar.planes(), kernel);
+		const double deinterleaveSeconds{ timer.elapsed() };
+
+		timer.reset();
+		for(int r{ 0 }; r < repetitions; ++r)
+			interleave(planar.constPlanes(), frameSize, packed.data(), kernel);
+		const double interleaveSeconds{ timer.elapsed() };
+
+		failures += (planar == reference && packed == frame) ? 0 : 1;
+		std::cout << kernelName(kernel) << ":\tdeinterleave " << gigabytesPerSecond(deinterleaveSeconds)
+			  << " GB/s\tinterleave " << gigabytesPerSecond(interleaveSeconds) << " GB/s\n";
+	}
+
+	std::cout << "\nTiles of " << pixelTileSize << " pixels, " << kernelName(bestPixelKernel()) << ":\n";
+	const std::size_t maxThreads{ std::max(1u, std::thread::hardware_concurrency()) };
+	for(std::size_t threads{ 1 }; threads <= maxThreads; threads *= 2)
+	{
+		std::unique_ptr<ThreadPool> pool{};
+		if(threads > 1)
+			pool = std::make_unique<ThreadPool>(threads);
+
+		Timer timer{};
+		for(int r{ 0 }; r < repetitions; ++r)
+			deinterleaveImage(frame.data(), frameSize, planar.planes(), pool.get());
+		const double deinterleaveSeconds{ timer.elapsed() };
+
+		timer.reset();
+		for(int r{ 0 }; r < repetitions; ++r)
+			interleaveImage(planar.constPlanes(), frameSize, packed.data(), pool.get());
+		const double interleaveSeconds{ timer.elapsed() };
+
+		failures += (planar == reference && packed == frame) ? 0 : 1;
+		std::cout << threads << " threads:\tdeinterleave " << gigabytesPerSecond(deinterleaveSeconds)
+			  << " GB/s\tinterleave " << gigabytesPerSecond(interleaveSeconds) << " GB/s\n";
+	}
+
+	std::cout << '\n' << failures << " failures\n";
+
+	return failures == 0 ? 0 : 1;
+}
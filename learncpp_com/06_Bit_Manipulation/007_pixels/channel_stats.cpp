@@ -0,0 +1,76 @@
+// Usage: channel_stats file.rgba [--threads N] [--histogram]
+// Prints min/max/mean of every channel of a raw RGBA file (four bytes per pixel: R, G, B, A),
+// streamed through mmap. --histogram also prints the nonzero bins.
+
+// Build: g++ -std=c++17 -O2 -pthread channel_stats.cpp histogram.cpp ../../08_Control_Flow_and_Error_Handling/008_primality/thread_pool.cpp
+
+#include "histogram.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/thread_pool.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/timer.h"
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+
+void printChannel(const char* name, const ChannelHistogram& histogram, bool bins)
+{
+	const ChannelSummary summary{ summarize(histogram) };
+	std::cout << name << ":\tmin " << static_cast<int>(summary.min) << "\tmax " << static_cast<int>(summary.max)
+		  << "\tmean " << summary.mean << '\n';
+
+	if(!bins)
+		return;
+
+	for(std::size_t value{ 0 }; value < histogram.size(); ++value)
+	{
+		if(histogram[value] != 0)
+			std::cout << '\t' << value << '\t' << histogram[value] << '\n';
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const char* path{ nullptr };
+	std::size_t threads{ 1 };
+	bool bins{ false };
+	for(int i{ 1 }; i < argc; ++i)
+	{
+		const std::string arg{ argv[i] };
+		if(arg == "--threads" && i + 1 < argc)
+			threads = std::stoul(argv[++i]);
+		else if(arg == "--histogram")
+			bins = true;
+		else
+			path = argv[i];
+	}
+
+	if(!path)
+	{
+		std::cerr << "Usage: channel_stats file.rgba [--threads N] [--histogram]\n";
+		return 1;
+	}
+
+	std::unique_ptr<ThreadPool> pool{};
+	if(threads > 1)
+		pool = std::make_unique<ThreadPool>(threads);
+
+	Timer timer{};
+	PixelHistogram histogram{};
+	std::string error{};
+	if(!histogramRgbaFile(path, histogram, pool.get(), error))
+	{
+		std::cerr << error << '\n';
+		return 1;
+	}
+	const double seconds{ timer.elapsed() };
+
+	std::cout << histogram.pixels << " pixels\n";
+	printChannel("red", histogram.red, bins);
+	printChannel("green", histogram.green, bins);
+	printChannel("blue", histogram.blue, bins);
+	printChannel("alpha", histogram.alpha, bins);
+	std::cerr << seconds << " s (" << (seconds > 0 ? 4.0 * static_cast<double>(histogram.pixels) / seconds / 1e9 : 0.0)
+		  << " GB/s)\n";
+
+	return 0;
+}
@@ -0,0 +1,160 @@
+// Parse a text file's worth of RRGGBBAA colors with std::istringstream >> std::hex (as 002_colors.cpp reads one),
+// std::from_chars, and parseHexColors() with every kernel the CPU supports; report MB/s and colors/s.
+// Malformed inputs check the reported error positions.
+
+// Build: g++ -std=c++17 -O2 -pthread hex_benchmark.cpp hex_colors.cpp pixels.cpp ../../08_Control_Flow_and_Error_Handling/008_primality/thread_pool.cpp
+
+#include "hex_colors.h"
+#include "pixels.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/timer.h"
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+constexpr std::size_t colorCount{ 10'000'000 };
+
+std::vector<std::uint32_t> parseIostream(const std::string& text)
+{
+	std::vector<std::uint32_t> values{};
+	std::istringstream in{ text };
+	std::uint32_t value{};
+	while(in >> std::hex >> value)
+		values.push_back(value);
+
+	return values;
+}
+
+std::vector<std::uint32_t> parseFromChars(const std::string& text)
+{
+	std::vector<std::uint32_t> values{};
+	const char* pos{ text.data() };
+	const char* end{ pos + text.size() };
+	while(pos < end)
+	{
+		std::uint32_t value{};
+		const auto [ptr, ec]{ std::from_chars(pos, end, value, 16) };
+		if(ec != std::errc{})
+			break;
+
+		values.push_back(value);
+		pos = ptr + 1;
+	}
+
+	return values;
+}
+
+void report(const char* name, double seconds, std::size_t bytes)
+{
+	std::cout << name << ":\t" << (seconds > 0 ? static_cast<double>(bytes) / seconds / 1e6 : 0.0) << " MB/s\t"
+		  << (seconds > 0 ? static_cast<double>(colorCount) / seconds / 1e6 : 0.0) << " M colors/s\n";
+}
+
+bool isSupported(PixelKernel kernel)
+{
+	return static_cast<int>(kernel) <= static_cast<int>(bestPixelKernel());
+}
+
+int checkErrors()
+{
+	struct Case
+	{
+		std::string text;
+		std::size_t offset;
+		std::string error;
+	};
+
+	const Case cases[]{
+		{ "00000000 1234567g\n", 16, "line 1, column 17: 'g' is not a hex digit" },
+		{ "deadbeef\nDEADBEEF\nabcdefgh\n", 24, "line 3, column 7: 'g' is not a hex digit" },
+		{ "11111111\n2222222\n", 9, "line 2, column 1: expected 8 hex digits, found 7" },
+		{ "11111111\n222222222\n", 9, "line 2, column 1: expected 8 hex digits, found 9" },
+		{ "ff00ff00 0xff00ff00", 10, "line 1, column 11: 'x' is not a hex digit" },
+		{ "1234567", 0, "line 1, column 1: expected 8 hex digits, found 7" },
+	};
+
+	int failures{ 0 };
+	for(PixelKernel kernel : { PixelKernel::scalar, PixelKernel::ssse3, PixelKernel::avx2 })
+	{
+		if(!isSupported(kernel))
+			continue;
+
+		for(const Case& test : cases)
+		{
+			// padding with good colors puts the bad token at every position of a SIMD group
+			for(std::size_t padding{ 0 }; padding < 5; ++padding)
+			{
+				std::string text{};
+				for(std::size_t i{ 0 }; i < padding; ++i)
+					text += "0123abcd\n";
+				text += test.text;
+
+				std::vector<std::uint32_t> values{};
+				std::size_t offset{};
+				std::string error{};
+				const bool ok{ parseHexColors(text.data(), text.size(), values, offset, error, kernel) };
+				const std::string expected{ "line " + std::to_string(std::stoul(test.error.substr(5)) + padding)
+							    + test.error.substr(test.error.find(',')) };
+				if(ok || offset != test.offset + padding * 9 || error != expected)
+				{
+					std::cout << kernelName(kernel) << ": \"" << test.text << "\" after " << padding << " colors gave "
+						  << offset << " \"" << error << "\"\n";
+					++failures;
+				}
+			}
+		}
+	}
+
+	return failures;
+}
+
+int main()
+{
+	std::mt19937 mt{ 2024 };
+	std::vector<std::uint32_t> colors(colorCount);
+	std::string text{};
+	text.reserve(colorCount * 9);
+	constexpr char lower[]{ "0123456789abcdef" };
+	constexpr char upper[]{ "0123456789ABCDEF" };
+	for(std::uint32_t& color : colors)
+	{
+		color = static_cast<std::uint32_t>(mt());
+		const char* digits{ mt() % 2 ? lower : upper };
+		for(int shift{ 28 }; shift >= 0; shift -= 4)
+			text += digits[color >> shift & 0xF];
+		text += '\n';
+	}
+
+	int failures{ checkErrors() };
+
+	Timer timer{};
+	failures += parseIostream(text) == colors ? 0 : 1;
+	report("iostream", timer.elapsed(), text.size());
+
+	timer.reset();
+	failures += parseFromChars(text) == colors ? 0 : 1;
+	report("from_chars", timer.elapsed(), text.size());
+
+	for(PixelKernel kernel : { PixelKernel::scalar, PixelKernel::ssse3, PixelKernel::avx2 })
+	{
+		if(!isSupported(kernel))
+			continue;
+
+		std::vector<std::uint32_t> values{};
+		values.reserve(colorCount);
+		std::size_t offset{};
+		std::string error{};
+		timer.reset();
+		const bool ok{ parseHexColors(text.data(), text.size(), values, offset, error, kernel) };
+		report(kernelName(kernel), timer.elapsed(), text.size());
+		failures += (ok && values == colors) ? 0 : 1;
+	}
+
+	std::cout << '\n' << failures << " failures\n";
+
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,268 @@
+#include "hex_colors.h"
+#include "pixels.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#include <immintrin.h>
+#define HEX_COLORS_X86 1
+#endif
+
+// Tokens located per call to decodeHexColors()
+constexpr std::size_t tokensPerBatch{ 4096 };
+
+constexpr std::size_t tokenLength{ 8 };
+
+// 0-15, or -1 for a character that is not a hex digit
+constexpr std::array<std::int8_t, 256> hexDigits{ []
+{
+	std::array<std::int8_t, 256> digits{};
+	for(int c{ 0 }; c < 256; ++c)
+	{
+		if(c >= '0' && c <= '9')
+			digits[c] = static_cast<std::int8_t>(c - '0');
+		else if(c >= 'a' && c <= 'f')
+			digits[c] = static_cast<std::int8_t>(c - 'a' + 10);
+		else if(c >= 'A' && c <= 'F')
+			digits[c] = static_cast<std::int8_t>(c - 'A' + 10);
+		else
+			digits[c] = -1;
+	}
+
+	return digits;
+}() };
+
+constexpr int hexDigit(char c)
+{
+	return hexDigits[static_cast<unsigned char>(c)];
+}
+
+constexpr bool isSeparator(char c)
+{
+	return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+bool parseHexColor(const char* token, std::uint32_t& value)
+{
+	// OR-ing the digits together catches a -1 anywhere with a single branch
+	std::uint32_t result{ 0 };
+	int check{ 0 };
+	for(std::size_t i{ 0 }; i < tokenLength; ++i)
+	{
+		const int digit{ hexDigit(token[i]) };
+		check |= digit;
+		result = result << 4 | static_cast<std::uint32_t>(digit & 0xF);
+	}
+
+	if(check < 0)
+		return false;
+
+	value = result;
+	return true;
+}
+
+std::size_t decodeScalar(const char* const* tokens, std::size_t count, std::uint32_t* values, std::size_t& badChar)
+{
+	for(std::size_t i{ 0 }; i < count; ++i)
+	{
+		if(!parseHexColor(tokens[i], values[i]))
+		{
+			badChar = 0;
+			while(hexDigit(tokens[i][badChar]) >= 0)
+				++badChar;
+			return i;
+		}
+	}
+
+	return count;
+}
+
+#ifdef HEX_COLORS_X86
+
+// Every character c becomes a nibble and a validity flag at once:
+//   digits are c - '0' <= 9, letters are (c | 0x20) - 'a' <= 5 (setting bit 5 lowercases A-F, and nothing
+//   outside the letters maps into a-f); unsigned "x <= n" is min(x, n) == x.
+//   The nibble is (c & 0xF) + 9 for letters, c & 0xF for digits.
+// maddubs then folds each pair of nibbles into a byte (high * 16 + low) in a 16-bit lane, and a byte shuffle
+// gathers the low bytes of each token's four lanes in reverse order: "RRGGBBAA" as a little-endian uint32.
+
+__attribute__((target("ssse3")))
+inline __m128i hexNibbles(__m128i chars, __m128i& invalid)
+{
+	const __m128i digit{ _mm_sub_epi8(chars, _mm_set1_epi8('0')) };
+	const __m128i letter{ _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a')) };
+	const __m128i isDigit{ _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit) };
+	const __m128i isLetter{ _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter) };
+
+	invalid = _mm_andnot_si128(_mm_or_si128(isDigit, isLetter), _mm_set1_epi8(-1));
+	return _mm_add_epi8(_mm_and_si128(chars, _mm_set1_epi8(0x0F)), _mm_and_si128(isLetter, _mm_set1_epi8(9)));
+}
+
+__attribute__((target("ssse3")))
+std::size_t decodeSsse3(const char* const* tokens, std::size_t count, std::uint32_t* values, std::size_t& badChar)
+{
+	const __m128i weights{ _mm_set1_epi16(0x0110) };       // bytes 16, 1: high nibble first
+	const __m128i gather{ _mm_setr_epi8(6, 4, 2, 0, 14, 12, 10, 8, -1, -1, -1, -1, -1, -1, -1, -1) };
+	std::size_t i{ 0 };
+	for(; i + 2 <= count; i += 2)
+	{
+		const __m128i chars{ _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(tokens[i])),
+							_mm_loadl_epi64(reinterpret_cast<const __m128i*>(tokens[i + 1]))) };
+		__m128i invalid{};
+		const __m128i nibbles{ hexNibbles(chars, invalid) };
+		if(_mm_movemask_epi8(invalid) != 0)
+			break;
+
+		const __m128i bytes{ _mm_shuffle_epi8(_mm_maddubs_epi16(nibbles, weights), gather) };
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(values + i), bytes);
+	}
+
+	// the tail, or the pair with the invalid token, gets the exact error from the scalar loop
+	return i + decodeScalar(tokens + i, count - i, values + i, badChar);
+}
+
+__attribute__((target("avx2")))
+std::size_t decodeAvx2(const char* const* tokens, std::size_t count, std::uint32_t* values, std::size_t& badChar)
+{
+	const __m256i weights{ _mm256_set1_epi16(0x0110) };
+	const __m256i gather{ _mm256_setr_epi8(6, 4, 2, 0, 14, 12, 10, 8, -1, -1, -1, -1, -1, -1, -1, -1,
+					       6, 4, 2, 0, 14, 12, 10, 8, -1, -1, -1, -1, -1, -1, -1, -1) };
+	std::size_t i{ 0 };
+	for(; i + 4 <= count; i += 4)
+	{
+		const __m128i low{ _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(tokens[i])),
+						      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(tokens[i + 1]))) };
+		const __m128i high{ _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(tokens[i + 2])),
+						       _mm_loadl_epi64(reinterpret_cast<const __m128i*>(tokens[i + 3]))) };
+		const __m256i chars{ _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1) };
+
+		const __m256i digit{ _mm256_sub_epi8(chars, _mm256_set1_epi8('0')) };
+		const __m256i letter{ _mm256_sub_epi8(_mm256_or_si256(chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a')) };
+		const __m256i isDigit{ _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit) };
+		const __m256i isLetter{ _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter) };
+		if(_mm256_movemask_epi8(_mm256_or_si256(isDigit, isLetter)) != -1)
+			break;
+
+		const __m256i nibbles{ _mm256_add_epi8(_mm256_and_si256(chars, _mm256_set1_epi8(0x0F)),
+						       _mm256_and_si256(isLetter, _mm256_set1_epi8(9))) };
+		const __m256i bytes{ _mm256_shuffle_epi8(_mm256_maddubs_epi16(nibbles, weights), gather) };
+
+		// each half holds two colors in its low 8 bytes
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(values + i),
+				 _mm256_castsi256_si128(_mm256_permute4x64_epi64(bytes, 0x08)));
+	}
+
+	return i + decodeScalar(tokens + i, count - i, values + i, badChar);
+}
+
+#endif
+
+std::size_t decodeHexColors(const char* const* tokens, std::size_t count, std::uint32_t* values, std::size_t& badChar,
+			    PixelKernel kernel)
+{
+#ifdef HEX_COLORS_X86
+	if(kernel == PixelKernel::avx2)
+		return decodeAvx2(tokens, count, values, badChar);
+	if(kernel == PixelKernel::ssse3)
+		return decodeSsse3(tokens, count, values, badChar);
+#endif
+
+	return decodeScalar(tokens, count, values, badChar);
+}
+
+std::string positionOf(const char* text, std::size_t offset)
+{
+	const std::size_t line{ 1 + static_cast<std::size_t>(std::count(text, text + offset, '\n')) };
+	const char* lineStart{ text + offset };
+	while(lineStart > text && lineStart[-1] != '\n')
+		--lineStart;
+
+	return "line " + std::to_string(line) + ", column " + std::to_string(text + offset - lineStart + 1);
+}
+
+bool parseHexColors(const char* text, std::size_t size, std::vector<std::uint32_t>& values, std::size_t& errorOffset,
+		    std::string& error, PixelKernel kernel)
+{
+	error.clear();
+	const char* const end{ text + size };
+	const char* tokens[tokensPerBatch]{};
+	std::size_t pending{ 0 };
+
+	// converts the located tokens; false, with the error set, if one has a bad character
+	auto flush{ [&]
+	{
+		const std::size_t first{ values.size() };
+		values.resize(first + pending);
+		std::size_t badChar{ 0 };
+		const std::size_t done{ decodeHexColors(tokens, pending, values.data() + first, badChar, kernel) };
+		if(done < pending)
+		{
+			values.resize(first + done);
+			errorOffset = static_cast<std::size_t>(tokens[done] + badChar - text);
+			if(isSeparator(text[errorOffset]))
+			{
+				// a short token that happened to span 8 characters, such as the last one of the text
+				errorOffset = static_cast<std::size_t>(tokens[done] - text);
+				error = positionOf(text, errorOffset) + ": expected 8 hex digits, found " + std::to_string(badChar);
+			}
+			else
+				error = positionOf(text, errorOffset) + ": '" + std::string(1, text[errorOffset]) + "' is not a hex digit";
+			return false;
+		}
+
+		pending = 0;
+		return true;
+	} };
+
+	const char* pos{ text };
+	while(true)
+	{
+		while(pos < end && isSeparator(*pos))
+			++pos;
+		if(pos == end)
+			break;
+
+		// the usual case, 8 characters followed by a separator or the end, is decoded without scanning;
+		// a separator among the 8 shows up as a bad character and is reported as a short token
+		const auto left{ static_cast<std::size_t>(end - pos) };
+		if(left >= tokenLength && (left == tokenLength || isSeparator(pos[tokenLength])))
+		{
+			tokens[pending++] = pos;
+			pos += tokenLength;
+			if(pending == tokensPerBatch && !flush())
+				return false;
+			continue;
+		}
+
+		// a token of the wrong length; the tokens before it come first, so an earlier error wins
+		if(!flush())
+			return false;
+
+		const char* tokenEnd{ pos };
+		while(tokenEnd < end && !isSeparator(*tokenEnd))
+			++tokenEnd;
+		const char* bad{ pos };
+		while(bad < tokenEnd && hexDigit(*bad) >= 0)
+			++bad;
+
+		if(bad < tokenEnd)
+		{
+			errorOffset = static_cast<std::size_t>(bad - text);
+			error = positionOf(text, errorOffset) + ": '" + std::string(1, *bad) + "' is not a hex digit";
+		}
+		else
+		{
+			errorOffset = static_cast<std::size_t>(pos - text);
+			error = positionOf(text, errorOffset) + ": expected 8 hex digits, found " + std::to_string(tokenEnd - pos);
+		}
+		return false;
+	}
+
+	return flush();
+}
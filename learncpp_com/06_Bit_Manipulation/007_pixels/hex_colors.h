@@ -0,0 +1,27 @@
+#ifndef HEX_COLORS_H
+#define HEX_COLORS_H
+
+#include "pixels.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+	// Bulk parsing of RRGGBBAA hex colors, the values 002_colors.cpp reads one at a time with std::cin >> std::hex.
+	// A token is exactly 8 hex digits, either case, with no prefix; tokens are separated by whitespace.
+
+	// Scalar parse of the 8 characters at token; false if one is not a hex digit
+	bool parseHexColor(const char* token, std::uint32_t& value);
+
+	// values[i] = the color at tokens[i], each pointing at 8 characters. The SIMD kernels validate and convert
+	// 2 (SSSE3) or 4 (AVX2) tokens per instruction. Returns count if every token is valid; otherwise the index
+	// of the first invalid token, with the index of its first bad character in badChar.
+	std::size_t decodeHexColors(const char* const* tokens, std::size_t count, std::uint32_t* values, std::size_t& badChar,
+				    PixelKernel kernel = bestPixelKernel());
+
+	// Appends every color in text[0, size) to values. On a malformed token stops and returns false, with the
+	// offset of the offending character in errorOffset and its line and column in error.
+	bool parseHexColors(const char* text, std::size_t size, std::vector<std::uint32_t>& values, std::size_t& errorOffset,
+			    std::string& error, PixelKernel kernel = bestPixelKernel());
+
+#endif
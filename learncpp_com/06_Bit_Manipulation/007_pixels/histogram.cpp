@@ -0,0 +1,249 @@
+#include "histogram.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/thread_pool.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Pixels per pool task; each task counts into its own tables and its result is merged at the end
+constexpr std::size_t pixelsPerTask{ 1 << 20 };
+
+// Pixels per window of a mapped file
+constexpr std::size_t pixelsPerWindow{ 16 << 20 };
+
+// Histograms indexed by the byte's position within the pixel, 0 being the lowest address
+using ByteHistograms = std::array<ChannelHistogram, 4>;
+
+// A run of equal pixels, common in real images, increments the same counter over and over, and every
+// increment has to wait for the previous store to be forwarded. Four consecutive pixels go to four
+// separate sets of tables instead, so neighbouring increments never touch the same counter.
+// The lanes' counters for one value sit next to each other: tables a multiple of 4 KiB apart would alias
+// in the store buffer and bring the stalls back. The 32-bit counters (16 KiB, fits in L1) are added
+// to the totals before they can overflow.
+constexpr std::size_t lanes{ 4 };
+constexpr std::size_t pixelsPerFlush{ lanes * 0xFFFF'FFFFull };
+
+void countBytes(const std::uint8_t* bytes, std::size_t pixels, ByteHistograms& totals)
+{
+	std::vector<std::uint32_t> tables(4 * 256 * lanes);
+	auto counter{ [&tables](std::size_t position, std::size_t value, std::size_t lane) -> std::uint32_t&
+	{
+		return tables[(position * 256 + value) * lanes + lane];
+	} };
+
+	while(pixels > 0)
+	{
+		const std::size_t block{ std::min(pixels, pixelsPerFlush) };
+		std::size_t i{ 0 };
+		for(; i + lanes <= block; i += lanes)
+		{
+			const std::uint8_t* pixel{ bytes + 4 * i };
+			for(std::size_t lane{ 0 }; lane < lanes; ++lane)
+			{
+				++counter(0, pixel[4 * lane + 0], lane);
+				++counter(1, pixel[4 * lane + 1], lane);
+				++counter(2, pixel[4 * lane + 2], lane);
+				++counter(3, pixel[4 * lane + 3], lane);
+			}
+		}
+		for(; i < block; ++i)
+		{
+			for(std::size_t position{ 0 }; position < 4; ++position)
+				++counter(position, bytes[4 * i + position], 0);
+		}
+
+		for(std::size_t position{ 0 }; position < 4; ++position)
+		{
+			for(std::size_t value{ 0 }; value < 256; ++value)
+			{
+				for(std::size_t lane{ 0 }; lane < lanes; ++lane)
+					totals[position][value] += counter(position, value, lane);
+			}
+		}
+		std::fill(tables.begin(), tables.end(), 0);
+
+		bytes += 4 * block;
+		pixels -= block;
+	}
+}
+
+// Counts on the pool, one partial result per task, then merges the partial results
+ByteHistograms countBytesParallel(const std::uint8_t* bytes, std::size_t pixels, ThreadPool* pool)
+{
+	ByteHistograms totals{};
+	if(!pool || pixels <= pixelsPerTask)
+	{
+		countBytes(bytes, pixels, totals);
+		return totals;
+	}
+
+	std::vector<ByteHistograms> partial((pixels + pixelsPerTask - 1) / pixelsPerTask);
+	for(std::size_t task{ 0 }; task < partial.size(); ++task)
+	{
+		const std::size_t first{ task * pixelsPerTask };
+		const std::size_t size{ std::min(pixelsPerTask, pixels - first) };
+		ByteHistograms* result{ &partial[task] };
+		pool->submit([bytes, first, size, result] { countBytes(bytes + 4 * first, size, *result); }, size);
+	}
+	pool->wait();
+
+	for(const ByteHistograms& part : partial)
+	{
+		for(std::size_t position{ 0 }; position < 4; ++position)
+		{
+			for(std::size_t value{ 0 }; value < 256; ++value)
+				totals[position][value] += part[position][value];
+		}
+	}
+
+	return totals;
+}
+
+PixelHistogram& PixelHistogram::operator+=(const PixelHistogram& other)
+{
+	pixels += other.pixels;
+	for(std::size_t value{ 0 }; value < 256; ++value)
+	{
+		red[value] += other.red[value];
+		green[value] += other.green[value];
+		blue[value] += other.blue[value];
+		alpha[value] += other.alpha[value];
+	}
+
+	return *this;
+}
+
+ChannelSummary summarize(const ChannelHistogram& histogram)
+{
+	ChannelSummary summary{};
+	std::uint64_t count{ 0 };
+	double sum{ 0.0 };
+	bool first{ true };
+	for(std::size_t value{ 0 }; value < 256; ++value)
+	{
+		if(histogram[value] == 0)
+			continue;
+
+		if(first)
+			summary.min = static_cast<std::uint8_t>(value);
+		summary.max = static_cast<std::uint8_t>(value);
+		first = false;
+
+		count += histogram[value];
+		sum += static_cast<double>(value) * static_cast<double>(histogram[value]);
+	}
+
+	if(count > 0)
+		summary.mean = sum / static_cast<double>(count);
+
+	return summary;
+}
+
+PixelHistogram histogram(const std::uint32_t* pixels, std::size_t count, ThreadPool* pool)
+{
+	const ByteHistograms byPosition{ countBytesParallel(reinterpret_cast<const std::uint8_t*>(pixels), count, pool) };
+
+	// the channel in each byte of a 0xRRGGBBAA value depends on the machine's byte order
+	PixelHistogram result{};
+	result.pixels = count;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	result.alpha = byPosition[0];
+	result.blue = byPosition[1];
+	result.green = byPosition[2];
+	result.red = byPosition[3];
+#else
+	result.red = byPosition[0];
+	result.green = byPosition[1];
+	result.blue = byPosition[2];
+	result.alpha = byPosition[3];
+#endif
+
+	return result;
+}
+
+PixelHistogram histogramRgbaBytes(const std::uint8_t* bytes, std::size_t pixels, ThreadPool* pool)
+{
+	const ByteHistograms byPosition{ countBytesParallel(bytes, pixels, pool) };
+
+	PixelHistogram result{};
+	result.pixels = pixels;
+	result.red = byPosition[0];
+	result.green = byPosition[1];
+	result.blue = byPosition[2];
+	result.alpha = byPosition[3];
+
+	return result;
+}
+
+std::string systemError(const std::string& what, const std::string& path)
+{
+	return what + " " + path + ": " + std::strerror(errno);
+}
+
+bool histogramRgbaFile(const std::string& path, PixelHistogram& result, ThreadPool* pool, std::string& error)
+{
+	result = {};
+	error.clear();
+
+	const int fd{ ::open(path.c_str(), O_RDONLY) };
+	if(fd < 0)
+	{
+		error = systemError("Can not open", path);
+		return false;
+	}
+
+	struct stat status{};
+	if(::fstat(fd, &status) != 0)
+	{
+		error = systemError("Can not stat", path);
+		::close(fd);
+		return false;
+	}
+	if(status.st_size % 4 != 0)
+	{
+		error = path + " is not a raw RGBA file: its size is not a multiple of 4";
+		::close(fd);
+		return false;
+	}
+
+	const auto size{ static_cast<std::size_t>(status.st_size) };
+	if(size == 0)
+	{
+		::close(fd);
+		return true;
+	}
+
+	void* mapping{ ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) };
+	::close(fd);
+	if(mapping == MAP_FAILED)
+	{
+		error = systemError("Can not map", path);
+		return false;
+	}
+
+	// read ahead aggressively, and give each window's pages back once it is counted,
+	// so a file larger than memory streams through instead of evicting everything else
+	::madvise(mapping, size, MADV_SEQUENTIAL);
+
+	const auto* bytes{ static_cast<const std::uint8_t*>(mapping) };
+	const std::size_t pixels{ size / 4 };
+	for(std::size_t first{ 0 }; first < pixels; first += pixelsPerWindow)
+	{
+		const std::size_t count{ std::min(pixelsPerWindow, pixels - first) };
+		result += histogramRgbaBytes(bytes + 4 * first, count, pool);
+		::madvise(const_cast<std::uint8_t*>(bytes + 4 * first), 4 * count, MADV_DONTNEED);
+	}
+
+	::munmap(mapping, size);
+
+	return true;
+}
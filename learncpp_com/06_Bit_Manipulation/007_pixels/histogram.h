@@ -0,0 +1,45 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class ThreadPool;
+
+	// Per-channel 256-bin histograms of many pixels, and the min/max/mean of each channel read off them
+	using ChannelHistogram = std::array<std::uint64_t, 256>;
+
+	struct PixelHistogram
+	{
+		std::uint64_t pixels{};
+		ChannelHistogram red{};
+		ChannelHistogram green{};
+		ChannelHistogram blue{};
+		ChannelHistogram alpha{};
+
+		PixelHistogram& operator+=(const PixelHistogram& other);
+	};
+
+	struct ChannelSummary
+	{
+		std::uint8_t min{};
+		std::uint8_t max{};
+		double mean{};
+	};
+
+	// All zero for an empty histogram
+	ChannelSummary summarize(const ChannelHistogram& histogram);
+
+	// Packed 0xRRGGBBAA pixels, as in 002_colors.cpp and pixels.h
+	PixelHistogram histogram(const std::uint32_t* pixels, std::size_t count, ThreadPool* pool = nullptr);
+
+	// Raw RGBA bytes, four per pixel in the order R, G, B, A, as image tools write them
+	PixelHistogram histogramRgbaBytes(const std::uint8_t* bytes, std::size_t pixels, ThreadPool* pool = nullptr);
+
+	// Streams a raw RGBA file through a read-only mapping, window by window, dropping each window once counted.
+	// The file size must be a multiple of 4.
+	bool histogramRgbaFile(const std::string& path, PixelHistogram& result, ThreadPool* pool, std::string& error);
+
+#endif
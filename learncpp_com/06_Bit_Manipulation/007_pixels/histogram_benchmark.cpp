@@ -0,0 +1,132 @@
+// Per-channel histograms of 4K frames: the single-table mask-and-shift loop against the per-lane tables of
+// histogram.cpp, on random pixels and on a solid color (every increment hits the same four counters),
+// then on 1, 2, 4, ... threads, and through a raw RGBA file.
+
+// Build: g++ -std=c++17 -O2 -pthread histogram_benchmark.cpp histogram.cpp ../../08_Control_Flow_and_Error_Handling/008_primality/thread_pool.cpp
+
+#include "histogram.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/thread_pool.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/timer.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr std::size_t frameSize{ 3840 * 2160 };
+constexpr int repetitions{ 10 };
+
+// The obvious loop, with the masks of 002_colors.cpp
+PixelHistogram histogramNaive(const std::uint32_t* pixels, std::size_t count)
+{
+	PixelHistogram result{};
+	result.pixels = count;
+	for(std::size_t i{ 0 }; i < count; ++i)
+	{
+		const std::uint32_t pixel{ pixels[i] };
+		++result.red[(pixel & 0xFF000000) >> 24];
+		++result.green[(pixel & 0x00FF0000) >> 16];
+		++result.blue[(pixel & 0x0000FF00) >> 8];
+		++result.alpha[pixel & 0x000000FF];
+	}
+
+	return result;
+}
+
+bool operator==(const PixelHistogram& a, const PixelHistogram& b)
+{
+	return a.pixels == b.pixels && a.red == b.red && a.green == b.green && a.blue == b.blue && a.alpha == b.alpha;
+}
+
+double gigabytesPerSecond(double seconds)
+{
+	return seconds > 0 ? static_cast<double>(frameSize * sizeof(std::uint32_t)) * repetitions / seconds / 1e9 : 0.0;
+}
+
+template <typename Function>
+double timeRepetitions(Function function)
+{
+	Timer timer{};
+	for(int r{ 0 }; r < repetitions; ++r)
+		function();
+
+	return timer.elapsed();
+}
+
+int main()
+{
+	std::mt19937 mt{ 2024 };
+	std::vector<std::uint32_t> randomFrame(frameSize);
+	for(std::uint32_t& pixel : randomFrame)
+		pixel = static_cast<std::uint32_t>(mt());
+	std::vector<std::uint32_t> solidFrame(frameSize, 0x336699FF);
+
+	int failures{ 0 };
+	for(std::size_t count : { 0, 1, 3, 5, 1000 })
+		failures += histogram(randomFrame.data(), count) == histogramNaive(randomFrame.data(), count) ? 0 : 1;
+
+	const ChannelSummary summary{ summarize(histogram(solidFrame.data(), frameSize).green) };
+	failures += (summary.min == 0x66 && summary.max == 0x66 && summary.mean == 0x66) ? 0 : 1;
+
+	for(const std::vector<std::uint32_t>* frame : { &randomFrame, &solidFrame })
+	{
+		const PixelHistogram reference{ histogramNaive(frame->data(), frameSize) };
+		PixelHistogram naive{};
+		PixelHistogram lanes{};
+		const double naiveSeconds{ timeRepetitions([&] { naive = histogramNaive(frame->data(), frameSize); }) };
+		const double laneSeconds{ timeRepetitions([&] { lanes = histogram(frame->data(), frameSize); }) };
+		failures += (naive == reference && lanes == reference) ? 0 : 1;
+
+		std::cout << (frame == &randomFrame ? "random pixels" : "solid color") << ":\tsingle table "
+			  << gigabytesPerSecond(naiveSeconds) << " GB/s\tper-lane tables " << gigabytesPerSecond(laneSeconds) << " GB/s\n";
+	}
+
+	const PixelHistogram reference{ histogramNaive(randomFrame.data(), frameSize) };
+	const std::size_t maxThreads{ std::max(1u, std::thread::hardware_concurrency()) };
+	for(std::size_t threads{ 1 }; threads <= maxThreads; threads *= 2)
+	{
+		std::unique_ptr<ThreadPool> pool{};
+		if(threads > 1)
+			pool = std::make_unique<ThreadPool>(threads);
+
+		PixelHistogram result{};
+		const double seconds{ timeRepetitions([&] { result = histogram(randomFrame.data(), frameSize, pool.get()); }) };
+		failures += result == reference ? 0 : 1;
+		std::cout << threads << " threads:\t" << gigabytesPerSecond(seconds) << " GB/s\n";
+	}
+
+	// the same frame as a raw RGBA file: bytes R, G, B, A whatever the machine's byte order
+	const std::string path{ "histogram_benchmark.rgba" };
+	std::FILE* file{ std::fopen(path.c_str(), "wb") };
+	for(std::size_t i{ 0 }; file && i < frameSize; ++i)
+	{
+		const std::uint32_t pixel{ randomFrame[i] };
+		const unsigned char bytes[4]{ static_cast<unsigned char>(pixel >> 24), static_cast<unsigned char>(pixel >> 16),
+					      static_cast<unsigned char>(pixel >> 8), static_cast<unsigned char>(pixel) };
+		std::fwrite(bytes, 1, sizeof(bytes), file);
+	}
+	if(file)
+		std::fclose(file);
+
+	PixelHistogram fromFile{};
+	std::string error{};
+	Timer timer{};
+	if(!histogramRgbaFile(path, fromFile, nullptr, error))
+	{
+		std::cerr << error << '\n';
+		++failures;
+	}
+	const double seconds{ timer.elapsed() };
+	std::remove(path.c_str());
+	failures += fromFile == reference ? 0 : 1;
+	std::cout << "mapped file:\t" << (seconds > 0 ? static_cast<double>(frameSize * 4) / seconds / 1e9 : 0.0) << " GB/s\n";
+
+	std::cout << '\n' << failures << " failures\n";
+
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,259 @@
+#include "pixels.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/thread_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#include <immintrin.h>
+#define PIXELS_X86 1
+#endif
+
+constexpr std::uint32_t redBits{ 0xFF000000 };
+constexpr std::uint32_t greenBits{ 0x00FF0000 };
+constexpr std::uint32_t blueBits{ 0x0000FF00 };
+constexpr std::uint32_t alphaBits{ 0x000000FF };
+
+void deinterleaveScalar(const std::uint32_t* pixels, std::size_t count, const Planes& planes)
+{
+	for(std::size_t i{ 0 }; i < count; ++i)
+	{
+		const std::uint32_t pixel{ pixels[i] };
+		planes.red[i] = static_cast<std::uint8_t>((pixel & redBits) >> 24);
+		planes.green[i] = static_cast<std::uint8_t>((pixel & greenBits) >> 16);
+		planes.blue[i] = static_cast<std::uint8_t>((pixel & blueBits) >> 8);
+		planes.alpha[i] = static_cast<std::uint8_t>(pixel & alphaBits);
+	}
+}
+
+void interleaveScalar(const ConstPlanes& planes, std::size_t count, std::uint32_t* pixels)
+{
+	for(std::size_t i{ 0 }; i < count; ++i)
+	{
+		pixels[i] = static_cast<std::uint32_t>(planes.red[i]) << 24 | static_cast<std::uint32_t>(planes.green[i]) << 16
+			  | static_cast<std::uint32_t>(planes.blue[i]) << 8 | planes.alpha[i];
+	}
+}
+
+#ifdef PIXELS_X86
+
+// In memory a little-endian pixel is the bytes A, B, G, R. The shuffle gathers each channel of four pixels
+// into one 32-bit lane (A in lane 0 ... R in lane 3); a 4x4 transpose of the lanes of four such registers
+// then leaves every channel of 16 pixels in its own register.
+__attribute__((target("ssse3")))
+inline __m128i channelGather()
+{
+	return _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+}
+
+__attribute__((target("ssse3")))
+void deinterleaveSsse3(const std::uint32_t* pixels, std::size_t count, const Planes& planes)
+{
+	const __m128i gather{ channelGather() };
+	std::size_t i{ 0 };
+	for(; i + 16 <= count; i += 16)
+	{
+		const auto* in{ reinterpret_cast<const __m128i*>(pixels + i) };
+		const __m128i v0{ _mm_shuffle_epi8(_mm_loadu_si128(in + 0), gather) };
+		const __m128i v1{ _mm_shuffle_epi8(_mm_loadu_si128(in + 1), gather) };
+		const __m128i v2{ _mm_shuffle_epi8(_mm_loadu_si128(in + 2), gather) };
+		const __m128i v3{ _mm_shuffle_epi8(_mm_loadu_si128(in + 3), gather) };
+
+		const __m128i alphaBlue01{ _mm_unpacklo_epi32(v0, v1) };
+		const __m128i greenRed01{ _mm_unpackhi_epi32(v0, v1) };
+		const __m128i alphaBlue23{ _mm_unpacklo_epi32(v2, v3) };
+		const __m128i greenRed23{ _mm_unpackhi_epi32(v2, v3) };
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(planes.alpha + i), _mm_unpacklo_epi64(alphaBlue01, alphaBlue23));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(planes.blue + i), _mm_unpackhi_epi64(alphaBlue01, alphaBlue23));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(planes.green + i), _mm_unpacklo_epi64(greenRed01, greenRed23));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(planes.red + i), _mm_unpackhi_epi64(greenRed01, greenRed23));
+	}
+
+	deinterleaveScalar(pixels + i, count - i, { planes.red + i, planes.green + i, planes.blue + i, planes.alpha + i });
+}
+
+// Byte then word unpacks of A with B and G with R rebuild four pixels per register
+__attribute__((target("ssse3")))
+void interleaveSsse3(const ConstPlanes& planes, std::size_t count, std::uint32_t* pixels)
+{
+	std::size_t i{ 0 };
+	for(; i + 16 <= count; i += 16)
+	{
+		const __m128i red{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes.red + i)) };
+		const __m128i green{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes.green + i)) };
+		const __m128i blue{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes.blue + i)) };
+		const __m128i alpha{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes.alpha + i)) };
+
+		const __m128i alphaBlueLow{ _mm_unpacklo_epi8(alpha, blue) };
+		const __m128i alphaBlueHigh{ _mm_unpackhi_epi8(alpha, blue) };
+		const __m128i greenRedLow{ _mm_unpacklo_epi8(green, red) };
+		const __m128i greenRedHigh{ _mm_unpackhi_epi8(green, red) };
+
+		auto* out{ reinterpret_cast<__m128i*>(pixels + i) };
+		_mm_storeu_si128(out + 0, _mm_unpacklo_epi16(alphaBlueLow, greenRedLow));
+		_mm_storeu_si128(out + 1, _mm_unpackhi_epi16(alphaBlueLow, greenRedLow));
+		_mm_storeu_si128(out + 2, _mm_unpacklo_epi16(alphaBlueHigh, greenRedHigh));
+		_mm_storeu_si128(out + 3, _mm_unpackhi_epi16(alphaBlueHigh, greenRedHigh));
+	}
+
+	interleaveScalar({ planes.red + i, planes.green + i, planes.blue + i, planes.alpha + i }, count - i, pixels + i);
+}
+
+// The AVX2 shuffles and unpacks work inside each 128-bit half, so the 32 pixels come out as two interleaved
+// groups of 16; one cross-lane permute per output puts them back in order.
+__attribute__((target("avx2")))
+void deinterleaveAvx2(const std::uint32_t* pixels, std::size_t count, const Planes& planes)
+{
+	const __m256i gather{ _mm256_broadcastsi128_si256(channelGather()) };
+	const __m256i order{ _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7) };
+	std::size_t i{ 0 };
+	for(; i + 32 <= count; i += 32)
+	{
+		const auto* in{ reinterpret_cast<const __m256i*>(pixels + i) };
+		const __m256i v0{ _mm256_shuffle_epi8(_mm256_loadu_si256(in + 0), gather) };
+		const __m256i v1{ _mm256_shuffle_epi8(_mm256_loadu_si256(in + 1), gather) };
+		const __m256i v2{ _mm256_shuffle_epi8(_mm256_loadu_si256(in + 2), gather) };
+		const __m256i v3{ _mm256_shuffle_epi8(_mm256_loadu_si256(in + 3), gather) };
+
+		const __m256i alphaBlue01{ _mm256_unpacklo_epi32(v0, v1) };
+		const __m256i greenRed01{ _mm256_unpackhi_epi32(v0, v1) };
+		const __m256i alphaBlue23{ _mm256_unpacklo_epi32(v2, v3) };
+		const __m256i greenRed23{ _mm256_unpackhi_epi32(v2, v3) };
+
+		const __m256i alpha{ _mm256_permutevar8x32_epi32(_mm256_unpacklo_epi64(alphaBlue01, alphaBlue23), order) };
+		const __m256i blue{ _mm256_permutevar8x32_epi32(_mm256_unpackhi_epi64(alphaBlue01, alphaBlue23), order) };
+		const __m256i green{ _mm256_permutevar8x32_epi32(_mm256_unpacklo_epi64(greenRed01, greenRed23), order) };
+		const __m256i red{ _mm256_permutevar8x32_epi32(_mm256_unpackhi_epi64(greenRed01, greenRed23), order) };
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(planes.alpha + i), alpha);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(planes.blue + i), blue);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(planes.green + i), green);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(planes.red + i), red);
+	}
+
+	deinterleaveScalar(pixels + i, count - i, { planes.red + i, planes.green + i, planes.blue + i, planes.alpha + i });
+}
+
+// The unpacks also stay inside each 128-bit half, so every register holds four pixels from the low half of the
+// planes and four from the high half; the 128-bit permutes pair them up in pixel order.
+__attribute__((target("avx2")))
+void interleaveAvx2(const ConstPlanes& planes, std::size_t count, std::uint32_t* pixels)
+{
+	std::size_t i{ 0 };
+	for(; i + 32 <= count; i += 32)
+	{
+		const __m256i red{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(planes.red + i)) };
+		const __m256i green{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(planes.green + i)) };
+		const __m256i blue{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(planes.blue + i)) };
+		const __m256i alpha{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(planes.alpha + i)) };
+
+		const __m256i alphaBlueLow{ _mm256_unpacklo_epi8(alpha, blue) };
+		const __m256i alphaBlueHigh{ _mm256_unpackhi_epi8(alpha, blue) };
+		const __m256i greenRedLow{ _mm256_unpacklo_epi8(green, red) };
+		const __m256i greenRedHigh{ _mm256_unpackhi_epi8(green, red) };
+
+		const __m256i p0{ _mm256_unpacklo_epi16(alphaBlueLow, greenRedLow) };      // pixels 0-3 | 16-19
+		const __m256i p1{ _mm256_unpackhi_epi16(alphaBlueLow, greenRedLow) };      // pixels 4-7 | 20-23
+		const __m256i p2{ _mm256_unpacklo_epi16(alphaBlueHigh, greenRedHigh) };    // pixels 8-11 | 24-27
+		const __m256i p3{ _mm256_unpackhi_epi16(alphaBlueHigh, greenRedHigh) };    // pixels 12-15 | 28-31
+
+		auto* out{ reinterpret_cast<__m256i*>(pixels + i) };
+		_mm256_storeu_si256(out + 0, _mm256_permute2x128_si256(p0, p1, 0x20));
+		_mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(p2, p3, 0x20));
+		_mm256_storeu_si256(out + 2, _mm256_permute2x128_si256(p0, p1, 0x31));
+		_mm256_storeu_si256(out + 3, _mm256_permute2x128_si256(p2, p3, 0x31));
+	}
+
+	interleaveScalar({ planes.red + i, planes.green + i, planes.blue + i, planes.alpha + i }, count - i, pixels + i);
+}
+
+#endif
+
+PixelKernel bestPixelKernel()
+{
+#ifdef PIXELS_X86
+	static const PixelKernel best{ __builtin_cpu_supports("avx2")    ? PixelKernel::avx2
+				       : __builtin_cpu_supports("ssse3") ? PixelKernel::ssse3
+									 : PixelKernel::scalar };
+	return best;
+#else
+	return PixelKernel::scalar;
+#endif
+}
+
+const char* kernelName(PixelKernel kernel)
+{
+	switch(kernel)
+	{
+		case PixelKernel::scalar:   return "scalar";
+		case PixelKernel::ssse3:    return "ssse3";
+		case PixelKernel::avx2:     return "avx2";
+	}
+
+	return "???";
+}
+
+void deinterleave(const std::uint32_t* pixels, std::size_t count, const Planes& planes, PixelKernel kernel)
+{
+#ifdef PIXELS_X86
+	if(kernel == PixelKernel::avx2)
+		return deinterleaveAvx2(pixels, count, planes);
+	if(kernel == PixelKernel::ssse3)
+		return deinterleaveSsse3(pixels, count, planes);
+#endif
+
+	deinterleaveScalar(pixels, count, planes);
+}
+
+void interleave(const ConstPlanes& planes, std::size_t count, std::uint32_t* pixels, PixelKernel kernel)
+{
+#ifdef PIXELS_X86
+	if(kernel == PixelKernel::avx2)
+		return interleaveAvx2(planes, count, pixels);
+	if(kernel == PixelKernel::ssse3)
+		return interleaveSsse3(planes, count, pixels);
+#endif
+
+	interleaveScalar(planes, count, pixels);
+}
+
+// Calls work(first, size) for every tile of [0, count), on the pool's workers when there is a pool
+template <typename Work>
+void forEachTile(std::size_t count, ThreadPool* pool, Work work)
+{
+	if(!pool || count <= pixelTileSize)
+	{
+		for(std::size_t first{ 0 }; first < count; first += pixelTileSize)
+			work(first, std::min(pixelTileSize, count - first));
+		return;
+	}
+
+	for(std::size_t first{ 0 }; first < count; first += pixelTileSize)
+	{
+		const std::size_t size{ std::min(pixelTileSize, count - first) };
+		pool->submit([work, first, size] { work(first, size); }, size);
+	}
+	pool->wait();
+}
+
+void deinterleaveImage(const std::uint32_t* pixels, std::size_t count, const Planes& planes, ThreadPool* pool,
+		       PixelKernel kernel)
+{
+	forEachTile(count, pool, [=](std::size_t first, std::size_t size)
+	{
+		deinterleave(pixels + first, size, { planes.red + first, planes.green + first, planes.blue + first, planes.alpha + first },
+			     kernel);
+	});
+}
+
+void interleaveImage(const ConstPlanes& planes, std::size_t count, std::uint32_t* pixels, ThreadPool* pool,
+		     PixelKernel kernel)
+{
+	forEachTile(count, pool, [=](std::size_t first, std::size_t size)
+	{
+		interleave({ planes.red + first, planes.green + first, planes.blue + first, planes.alpha + first }, size,
+			   pixels + first, kernel);
+	});
+}
@@ -0,0 +1,55 @@
+#ifndef PIXELS_H
+#define PIXELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+class ThreadPool;
+
+	// Bulk versions of the mask-and-shift unpacking in 002_colors.cpp.
+	// A packed pixel is the 32-bit value 0xRRGGBBAA; the planar form keeps each channel in its own byte array.
+
+	struct Planes
+	{
+		std::uint8_t* red{};
+		std::uint8_t* green{};
+		std::uint8_t* blue{};
+		std::uint8_t* alpha{};
+	};
+
+	struct ConstPlanes
+	{
+		const std::uint8_t* red{};
+		const std::uint8_t* green{};
+		const std::uint8_t* blue{};
+		const std::uint8_t* alpha{};
+	};
+
+	// SSSE3 and AVX2 kernels shuffle bytes, so they are only used on little-endian x86, where they give the
+	// same result as the scalar masks and shifts. bestPixelKernel() is the fastest one the CPU supports;
+	// passing a kernel the CPU does not support is undefined.
+	enum class PixelKernel
+	{
+		scalar,
+		ssse3,
+		avx2,
+	};
+
+	PixelKernel bestPixelKernel();
+	const char* kernelName(PixelKernel kernel);
+
+	void deinterleave(const std::uint32_t* pixels, std::size_t count, const Planes& planes,
+			  PixelKernel kernel = bestPixelKernel());
+	void interleave(const ConstPlanes& planes, std::size_t count, std::uint32_t* pixels,
+			PixelKernel kernel = bestPixelKernel());
+
+	// Whole frames, split into tiles of pixelTileSize pixels. A tile's packed and planar bytes together take
+	// 128 KiB, so one tile stays in a core's L2 cache. With a pool the tiles run on its workers.
+	inline constexpr std::size_t pixelTileSize{ 16 * 1024 };
+
+	void deinterleaveImage(const std::uint32_t* pixels, std::size_t count, const Planes& planes, ThreadPool* pool = nullptr,
+			       PixelKernel kernel = bestPixelKernel());
+	void interleaveImage(const ConstPlanes& planes, std::size_t count, std::uint32_t* pixels, ThreadPool* pool = nullptr,
+			     PixelKernel kernel = bestPixelKernel());
+
+#endif
@@ -0,0 +1,102 @@
+#include "article_flags.h"
+#include "roaring.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+// Returned by articles() for bits that are not options
+const RoaringBitmap noArticles{};
+
+// The option bits of a mask, lowest first, as indices into the bitmap array
+template <typename Visitor>
+void forEachOption(std::uint_fast8_t mask, Visitor visit)
+{
+	for(std::size_t i{ 0 }; i < optionCount; ++i)
+	{
+		if(mask & (1u << i))
+			visit(i);
+	}
+}
+
+void ArticleFlagStore::set(std::uint32_t article, std::uint_fast8_t mask)
+{
+	forEachOption(mask, [&](std::size_t i) { m_options[i].add(article); });
+}
+
+void ArticleFlagStore::clear(std::uint32_t article, std::uint_fast8_t mask)
+{
+	forEachOption(mask, [&](std::size_t i) { m_options[i].remove(article); });
+}
+
+std::uint_fast8_t ArticleFlagStore::flags(std::uint32_t article) const
+{
+	std::uint_fast8_t result{ 0 };
+	for(std::size_t i{ 0 }; i < optionCount; ++i)
+	{
+		if(m_options[i].contains(article))
+			result |= static_cast<std::uint_fast8_t>(1u << i);
+	}
+
+	return result;
+}
+
+bool isSingleOption(std::uint_fast8_t mask)
+{
+	return mask != 0 && (mask & (mask - 1)) == 0;
+}
+
+const RoaringBitmap& ArticleFlagStore::articles(std::uint_fast8_t option) const
+{
+	assert(isSingleOption(option) && "Not a single option");
+	if((option & allOptions) == 0)
+		return noArticles;
+
+	return m_options[__builtin_ctz(option)];
+}
+
+RoaringBitmap ArticleFlagStore::select(std::uint_fast8_t required, std::uint_fast8_t excluded) const
+{
+	assert(required != 0 && "select needs at least one required option");
+	if(required == 0 || (required & ~allOptions))
+		return {};
+
+	RoaringBitmap result{};
+	bool first{ true };
+	forEachOption(required, [&](std::size_t i)
+	{
+		result = first ? m_options[i] : intersect(result, m_options[i]);
+		first = false;
+	});
+	forEachOption(excluded, [&](std::size_t i) { result = subtract(result, m_options[i]); });
+
+	return result;
+}
+
+std::uint64_t ArticleFlagStore::count(std::uint_fast8_t required, std::uint_fast8_t excluded) const
+{
+	assert(required != 0 && "count needs at least one required option");
+	if(required == 0 || (required & ~allOptions))
+		return 0;
+	excluded &= allOptions;
+
+	// the common one- and two-option queries are counted straight from the containers, without building a result
+	const auto rest{ static_cast<std::uint_fast8_t>(required & (required - 1)) };     // required without its lowest option
+	if(rest == 0 && excluded == 0)
+		return articles(required).cardinality();
+	if(rest == 0 && isSingleOption(excluded))
+		return subtractCardinality(articles(required), articles(excluded));
+	if(isSingleOption(rest) && excluded == 0)
+		return intersectCardinality(articles(static_cast<std::uint_fast8_t>(required ^ rest)), articles(rest));
+
+	return select(required, excluded).cardinality();
+}
+
+std::size_t ArticleFlagStore::memoryUsage() const
+{
+	std::size_t bytes{ 0 };
+	for(const RoaringBitmap& bitmap : m_options)
+		bytes += bitmap.memoryUsage();
+
+	return bytes;
+}
@@ -0,0 +1,47 @@
+#ifndef ARTICLE_FLAGS_H
+#define ARTICLE_FLAGS_H
+
+#include "roaring.h"
+#include <cstddef>
+#include <cstdint>
+
+	// The article options of 003_article_property_manipulation.cpp, with the same bit values
+	inline constexpr std::uint_fast8_t option_viewed{ 0x01 };
+	inline constexpr std::uint_fast8_t option_edited{ 0x02 };
+	inline constexpr std::uint_fast8_t option_favorited{ 0x04 };
+	inline constexpr std::uint_fast8_t option_shared{ 0x08 };
+	inline constexpr std::uint_fast8_t option_deleted{ 0x10 };
+
+	inline constexpr std::size_t optionCount{ 5 };
+	inline constexpr std::uint_fast8_t allOptions{ (1u << optionCount) - 1 };
+
+	// Flags of many articles, stored as one compressed bitmap of article ids per option
+	// instead of one flags byte per article.
+	// Bits outside allOptions are never set: set() and clear() ignore them,
+	// requiring one matches no article and excluding one changes nothing.
+	class ArticleFlagStore
+	{
+	private:
+		RoaringBitmap m_options[optionCount]{};
+
+	public:
+		// Set or clear every option in mask for the article
+		void set(std::uint32_t article, std::uint_fast8_t mask);
+		void clear(std::uint32_t article, std::uint_fast8_t mask);
+
+		// The article's flags byte, as 003_article_property_manipulation.cpp keeps it
+		std::uint_fast8_t flags(std::uint32_t article) const;
+		bool has(std::uint32_t article, std::uint_fast8_t option) const { return flags(article) & option; }
+
+		// The bitmap of a single option; an empty bitmap for a bit outside allOptions
+		const RoaringBitmap& articles(std::uint_fast8_t option) const;
+
+		// Articles with every option in required and none in excluded, e.g. select(option_viewed, option_deleted).
+		// required must not be 0.
+		RoaringBitmap select(std::uint_fast8_t required, std::uint_fast8_t excluded = 0) const;
+		std::uint64_t count(std::uint_fast8_t required, std::uint_fast8_t excluded = 0) const;
+
+		std::size_t memoryUsage() const;
+	};
+
+#endif
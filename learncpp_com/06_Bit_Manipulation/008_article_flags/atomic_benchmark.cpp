@@ -0,0 +1,202 @@
+// Usage: atomic_benchmark [max threads=64]
+// Threads hammering AtomicFlagTable (packed and padded) and a mutex-guarded flags array with a mix of
+// set, conditional update, clear and read, on a million articles, 64 hot neighbouring articles and a
+// single article, for 1, 2, 4, ... threads. Before that, checks that updates to articles sharing a word
+// are never lost and that update() excludes itself like a lock.
+
+// Build: g++ -std=c++17 -O2 -pthread atomic_benchmark.cpp
+
+#include "atomic_flags.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/timer.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr std::size_t operationsPerRun{ 4'000'000 };
+
+std::atomic<std::uint64_t> readChecksum{ 0 };
+
+// The same interface over one flags byte per article and one lock, the way 003_article_property_manipulation.cpp
+// would be shared between threads
+class LockedFlagTable
+{
+private:
+	std::mutex m_mutex{};
+	std::vector<std::uint_fast8_t> m_flags{};
+
+public:
+	explicit LockedFlagTable(std::size_t articleCount)
+		: m_flags(articleCount)
+	{
+	}
+
+	std::uint_fast8_t set(std::uint32_t article, std::uint_fast8_t mask)
+	{
+		const std::lock_guard lock{ m_mutex };
+		const std::uint_fast8_t previous{ m_flags[article] };
+		m_flags[article] |= mask;
+		return previous;
+	}
+
+	std::uint_fast8_t clear(std::uint32_t article, std::uint_fast8_t mask)
+	{
+		const std::lock_guard lock{ m_mutex };
+		const std::uint_fast8_t previous{ m_flags[article] };
+		m_flags[article] &= static_cast<std::uint_fast8_t>(~mask);
+		return previous;
+	}
+
+	std::uint_fast8_t flags(std::uint32_t article)
+	{
+		const std::lock_guard lock{ m_mutex };
+		return m_flags[article];
+	}
+
+	bool update(std::uint32_t article, const FlagTransition& transition)
+	{
+		const std::lock_guard lock{ m_mutex };
+		std::uint_fast8_t& flags{ m_flags[article] };
+		if((flags & transition.required) != transition.required || (flags & transition.forbidden) != 0)
+			return false;
+
+		flags = static_cast<std::uint_fast8_t>((flags | transition.set) & ~transition.clear);
+		return true;
+	}
+};
+
+template <FlagLayout layout>
+int checkTable(std::size_t threadCount)
+{
+	int failures{ 0 };
+
+	// every thread owns one article of the same word and flips its own options
+	{
+		AtomicFlagTable<layout> table{ 8 };
+		std::vector<std::thread> threads{};
+		for(std::uint32_t article{ 0 }; article < 8; ++article)
+		{
+			threads.emplace_back([&table, article]
+			{
+				for(int i{ 0 }; i < 100000; ++i)
+				{
+					table.set(article, option_viewed | option_shared);
+					table.clear(article, option_shared);
+					table.update(article, { option_viewed, 0, option_edited, option_viewed });
+				}
+			});
+		}
+		for(std::thread& thread : threads)
+			thread.join();
+
+		for(std::uint32_t article{ 0 }; article < 8; ++article)
+			failures += table.flags(article) == option_edited ? 0 : 1;
+	}
+
+	// "set edited only if not edited" used as a lock: never two holders at once
+	{
+		AtomicFlagTable<layout> table{ 1 };
+		std::atomic<int> holders{ 0 };
+		std::atomic<int> overlaps{ 0 };
+		std::atomic<std::uint64_t> acquired{ 0 };
+		std::vector<std::thread> threads{};
+		for(std::size_t t{ 0 }; t < threadCount; ++t)
+		{
+			threads.emplace_back([&]
+			{
+				for(int i{ 0 }; i < 20000; ++i)
+				{
+					if(!table.update(0, { 0, option_edited, option_edited, 0 }))
+						continue;
+
+					if(holders.fetch_add(1) != 0)
+						++overlaps;
+					++acquired;
+					holders.fetch_sub(1);
+					table.clear(0, option_edited);
+				}
+			});
+		}
+		for(std::thread& thread : threads)
+			thread.join();
+
+		failures += (overlaps == 0 && acquired > 0 && table.flags(0) == 0) ? 0 : 1;
+	}
+
+	return failures;
+}
+
+// Each thread cycles through set, "favorite only if not deleted", clear and read
+// on articles drawn from [0, articleCount)
+template <typename Table>
+double run(std::size_t threadCount, std::uint32_t articleCount)
+{
+	Table table{ articleCount };
+	std::atomic<bool> start{ false };
+	std::vector<std::thread> threads{};
+	const std::size_t perThread{ operationsPerRun / threadCount };
+	for(std::size_t t{ 0 }; t < threadCount; ++t)
+	{
+		threads.emplace_back([&table, &start, perThread, articleCount, t]
+		{
+			std::mt19937 mt{ static_cast<std::uint32_t>(t + 1) };
+			std::uint64_t seen{ 0 };
+			while(!start.load(std::memory_order_acquire))
+				std::this_thread::yield();
+
+			for(std::size_t i{ 0 }; i < perThread; i += 4)
+			{
+				const auto article{ static_cast<std::uint32_t>(mt() % articleCount) };
+				table.set(article, option_viewed);
+				table.update(article, { 0, option_deleted, option_favorited, 0 });
+				table.clear(article, option_favorited);
+				seen += table.flags(article);
+			}
+
+			readChecksum.fetch_add(seen, std::memory_order_relaxed);       // keeps the reads from being optimized away
+		});
+	}
+
+	Timer timer{};
+	start.store(true, std::memory_order_release);
+	for(std::thread& thread : threads)
+		thread.join();
+
+	return timer.elapsed();
+}
+
+int main(int argc, char* argv[])
+{
+	const std::size_t maxThreads{ argc > 1 ? std::stoul(argv[1]) : 64 };
+
+	const int failures{ checkTable<FlagLayout::packed>(8) + checkTable<FlagLayout::padded>(8) };
+	std::cout << failures << " failures, " << std::thread::hardware_concurrency() << " hardware threads\n"
+		  << "million operations per second:\n";
+
+	struct Workload
+	{
+		const char* name;
+		std::uint32_t articles;
+	};
+
+	for(const Workload& workload : { Workload{ "1M articles", 1'000'000 }, Workload{ "64 hot articles", 64 },
+					 Workload{ "1 article", 1 } })
+	{
+		std::cout << '\n' << workload.name << "\nthreads\tpacked\tpadded\tmutex\n";
+		for(std::size_t threads{ 1 }; threads <= maxThreads; threads *= 2)
+		{
+			const double packed{ run<AtomicFlagTable<FlagLayout::packed>>(threads, workload.articles) };
+			const double padded{ run<AtomicFlagTable<FlagLayout::padded>>(threads, workload.articles) };
+			const double locked{ run<LockedFlagTable>(threads, workload.articles) };
+			std::cout << threads << '\t' << operationsPerRun / packed / 1e6 << '\t' << operationsPerRun / padded / 1e6
+				  << '\t' << operationsPerRun / locked / 1e6 << '\n';
+		}
+	}
+
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+#ifndef ATOMIC_FLAGS_H
+#define ATOMIC_FLAGS_H
+
+#include "article_flags.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Flags of a fixed number of articles that many threads update at once, without locks.
+// Every article's flags byte (the option_* bits of article_flags.h) lives inside one std::atomic<uint64_t>,
+// so `flags |= option` and `flags &= ~option` from 003_article_property_manipulation.cpp become a single
+// fetch_or / fetch_and, and transitions that depend on the current flags are a compare-and-swap loop.
+//
+// The layout is a template parameter:
+//   packed - eight articles per word, words contiguous: one byte per article, but threads updating
+//            neighbouring articles fight over the same cache line
+//   padded - one article per word and one word per cache line: 64 bytes per article, for small sets
+//            of hot articles where that contention dominates
+
+enum class FlagLayout
+{
+	packed,
+	padded,
+};
+
+// A conditional update: applies when every required option is set and no forbidden one is,
+// then sets the options in set and clears those in clear.
+// "Mark viewed only if not deleted" is { 0, option_deleted, option_viewed, 0 }.
+struct FlagTransition
+{
+	std::uint_fast8_t required{};
+	std::uint_fast8_t forbidden{};
+	std::uint_fast8_t set{};
+	std::uint_fast8_t clear{};
+};
+
+template <FlagLayout layout>
+class AtomicFlagTable
+{
+private:
+	static constexpr std::size_t articlesPerWord{ layout == FlagLayout::packed ? 8 : 1 };
+
+	struct alignas(layout == FlagLayout::packed ? alignof(std::atomic<std::uint64_t>) : 64) Word
+	{
+		std::atomic<std::uint64_t> bits{};
+	};
+
+	std::unique_ptr<Word[]> m_words{};
+	std::size_t m_articleCount{};
+
+	std::atomic<std::uint64_t>& wordFor(std::uint32_t article) const
+	{
+		return m_words[article / articlesPerWord].bits;
+	}
+
+	static constexpr unsigned shiftFor(std::uint32_t article)
+	{
+		return static_cast<unsigned>(article % articlesPerWord) * 8;
+	}
+
+	static constexpr std::uint_fast8_t byteAt(std::uint64_t word, unsigned shift)
+	{
+		return static_cast<std::uint_fast8_t>((word >> shift) & 0xFF);
+	}
+
+public:
+	static_assert(sizeof(Word) == (layout == FlagLayout::packed ? 8 : 64));
+	static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+	explicit AtomicFlagTable(std::size_t articleCount)
+		: m_words{ new Word[(articleCount + articlesPerWord - 1) / articlesPerWord]{} }, m_articleCount{ articleCount }
+	{
+	}
+
+	std::size_t size() const { return m_articleCount; }
+	std::size_t memoryUsage() const { return (m_articleCount + articlesPerWord - 1) / articlesPerWord * sizeof(Word); }
+
+	// Read-modify-writes are acq_rel and loads acquire, so a thread that sees an option set also sees
+	// whatever the setting thread wrote before setting it.
+
+	// Both return the article's flags from before the update
+	std::uint_fast8_t set(std::uint32_t article, std::uint_fast8_t mask)
+	{
+		const unsigned shift{ shiftFor(article) };
+		return byteAt(wordFor(article).fetch_or(std::uint64_t{ mask } << shift, std::memory_order_acq_rel), shift);
+	}
+
+	std::uint_fast8_t clear(std::uint32_t article, std::uint_fast8_t mask)
+	{
+		const unsigned shift{ shiftFor(article) };
+		return byteAt(wordFor(article).fetch_and(~(std::uint64_t{ mask } << shift), std::memory_order_acq_rel), shift);
+	}
+
+	std::uint_fast8_t flags(std::uint32_t article) const
+	{
+		return byteAt(wordFor(article).load(std::memory_order_acquire), shiftFor(article));
+	}
+
+	// Applies the transition atomically if its conditions hold. previous receives the flags it was checked against.
+	bool update(std::uint32_t article, const FlagTransition& transition, std::uint_fast8_t* previous = nullptr)
+	{
+		std::atomic<std::uint64_t>& word{ wordFor(article) };
+		const unsigned shift{ shiftFor(article) };
+
+		std::uint64_t expected{ word.load(std::memory_order_acquire) };
+		while(true)
+		{
+			const std::uint_fast8_t current{ byteAt(expected, shift) };
+			if(previous)
+				*previous = current;
+			if((current & transition.required) != transition.required || (current & transition.forbidden) != 0)
+				return false;
+
+			const std::uint64_t desired{ (expected | std::uint64_t{ transition.set } << shift)
+						     & ~(std::uint64_t{ transition.clear } << shift) };
+			if(desired == expected
+			   || word.compare_exchange_weak(expected, desired, std::memory_order_acq_rel, std::memory_order_acquire))
+				return true;
+			// expected now holds the current word, which another article in it may have changed; check again
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,163 @@
+// Usage: benchmark [articles=100000000]
+// Random flags for every article, kept both as one flags byte per article (003_article_property_manipulation.cpp)
+// and in ArticleFlagStore. Compares memory and the time to count queries such as "viewed and not deleted",
+// after checking the compressed bitmaps against std::set on small random sets.
+
+// Build: g++ -std=c++17 -O2 benchmark.cpp article_flags.cpp roaring.cpp
+
+#include "article_flags.h"
+#include "roaring.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/timer.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+// Adds and removes random values around container boundaries, then compares every operation with std::set
+int checkAgainstSet()
+{
+	std::mt19937 mt{ 2024 };
+	int failures{ 0 };
+	for(int round{ 0 }; round < 40; ++round)
+	{
+		// densities from a few values per container to nearly full ones, so both container kinds meet
+		const std::uint32_t span{ 3u << 16 };
+		const std::uint32_t sizeA{ static_cast<std::uint32_t>(mt() % 150000) };
+		const std::uint32_t sizeB{ static_cast<std::uint32_t>(mt() % 150000) };
+
+		RoaringBitmap a{};
+		RoaringBitmap b{};
+		std::set<std::uint32_t> setA{};
+		std::set<std::uint32_t> setB{};
+		for(std::uint32_t i{ 0 }; i < sizeA; ++i)
+		{
+			const std::uint32_t value{ static_cast<std::uint32_t>(mt() % span) };
+			failures += a.add(value) == setA.insert(value).second ? 0 : 1;
+		}
+		for(std::uint32_t i{ 0 }; i < sizeB; ++i)
+		{
+			const std::uint32_t value{ static_cast<std::uint32_t>(mt() % span) };
+			failures += b.add(value) == setB.insert(value).second ? 0 : 1;
+		}
+		for(std::uint32_t i{ 0 }; i < sizeA / 2; ++i)
+		{
+			const std::uint32_t value{ static_cast<std::uint32_t>(mt() % span) };
+			failures += a.remove(value) == (setA.erase(value) == 1) ? 0 : 1;
+		}
+
+		std::vector<std::uint32_t> expected{};
+		std::set_intersection(setA.begin(), setA.end(), setB.begin(), setB.end(), std::back_inserter(expected));
+		failures += (intersect(a, b).values() == expected && intersectCardinality(a, b) == expected.size()) ? 0 : 1;
+
+		expected.clear();
+		std::set_difference(setA.begin(), setA.end(), setB.begin(), setB.end(), std::back_inserter(expected));
+		failures += (subtract(a, b).values() == expected && subtractCardinality(a, b) == expected.size()) ? 0 : 1;
+
+		expected.clear();
+		std::set_union(setA.begin(), setA.end(), setB.begin(), setB.end(), std::back_inserter(expected));
+		failures += unite(a, b).values() == expected ? 0 : 1;
+
+		failures += (a.values() == std::vector<std::uint32_t>(setA.begin(), setA.end()) && a.cardinality() == setA.size()) ? 0 : 1;
+	}
+
+	return failures;
+}
+
+// Counts articles whose byte has every option in required and none in excluded
+std::uint64_t countBytes(const std::vector<std::uint_fast8_t>& flags, std::uint_fast8_t required, std::uint_fast8_t excluded)
+{
+	const auto mask{ static_cast<std::uint_fast8_t>(required | excluded) };
+	std::uint64_t count{ 0 };
+	for(std::uint_fast8_t articleFlags : flags)
+		count += (articleFlags & mask) == required;
+
+	return count;
+}
+
+int main(int argc, char* argv[])
+{
+	const std::uint32_t articleCount{ argc > 1 ? static_cast<std::uint32_t>(std::stoul(argv[1])) : 100'000'000u };
+
+	int failures{ checkAgainstSet() };
+
+	// share of articles with each option, in option bit order
+	constexpr double shares[optionCount]{ 0.6, 0.05, 0.01, 0.005, 0.02 };
+	std::mt19937_64 mt{ 2024 };
+	std::uniform_real_distribution<double> uniform{ 0.0, 1.0 };
+
+	std::vector<std::uint_fast8_t> bytes(articleCount);
+	for(std::uint_fast8_t& articleFlags : bytes)
+	{
+		for(std::size_t i{ 0 }; i < optionCount; ++i)
+		{
+			if(uniform(mt) < shares[i])
+				articleFlags |= static_cast<std::uint_fast8_t>(1u << i);
+		}
+	}
+
+	Timer timer{};
+	ArticleFlagStore store{};
+	for(std::uint32_t article{ 0 }; article < articleCount; ++article)
+		store.set(article, bytes[article]);
+	const double buildSeconds{ timer.elapsed() };
+
+	for(int i{ 0 }; i < 100000; ++i)
+	{
+		const auto article{ static_cast<std::uint32_t>(mt() % articleCount) };
+		failures += store.flags(article) == bytes[article] ? 0 : 1;
+	}
+
+	std::cout << articleCount << " articles, built in " << buildSeconds << " s\n"
+		  << "one byte per article: " << articleCount * sizeof(std::uint_fast8_t) / (1 << 20) << " MiB, bitmaps: "
+		  << store.memoryUsage() / (1 << 20) << " MiB\n";
+	const char* names[optionCount]{ "viewed", "edited", "favorited", "shared", "deleted" };
+	for(std::size_t i{ 0 }; i < optionCount; ++i)
+	{
+		const RoaringBitmap& bitmap{ store.articles(static_cast<std::uint_fast8_t>(1u << i)) };
+		std::cout << '\t' << names[i] << ": " << bitmap.cardinality() << " articles, " << bitmap.containerCount()
+			  << " containers (" << bitmap.bitmapContainerCount() << " bitmaps), " << bitmap.memoryUsage() / 1024 << " KiB\n";
+	}
+	std::cout << '\n';
+
+	struct Query
+	{
+		const char* name;
+		std::uint_fast8_t required;
+		std::uint_fast8_t excluded;
+	};
+
+	const Query queries[]{
+		{ "viewed and not deleted", option_viewed, option_deleted },
+		{ "edited and not deleted", option_edited, option_deleted },
+		{ "favorited and shared", option_favorited | option_shared, 0 },
+		{ "viewed, favorited, not deleted", option_viewed | option_favorited, option_deleted },
+	};
+
+	for(const Query& query : queries)
+	{
+		timer.reset();
+		const std::uint64_t expected{ countBytes(bytes, query.required, query.excluded) };
+		const double scanSeconds{ timer.elapsed() };
+
+		timer.reset();
+		const std::uint64_t counted{ store.count(query.required, query.excluded) };
+		const double countSeconds{ timer.elapsed() };
+
+		timer.reset();
+		const RoaringBitmap selected{ store.select(query.required, query.excluded) };
+		const double selectSeconds{ timer.elapsed() };
+
+		failures += (counted == expected && selected.cardinality() == expected) ? 0 : 1;
+		std::cout << query.name << ": " << expected << "\n\tbyte scan " << scanSeconds * 1e3 << " ms, count "
+			  << countSeconds * 1e3 << " ms, select " << selectSeconds * 1e3 << " ms\n";
+	}
+
+	std::cout << '\n' << failures << " failures\n";
+
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,469 @@
+#include "roaring.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ROARING_X86 1
+#endif
+
+enum class SetOperation
+{
+	intersect,
+	subtract,
+	unite,
+};
+
+template <SetOperation op>
+inline std::uint64_t combineWord(std::uint64_t a, std::uint64_t b)
+{
+	if constexpr(op == SetOperation::intersect)
+		return a & b;
+	else if constexpr(op == SetOperation::subtract)
+		return a & ~b;
+	else
+		return a | b;
+}
+
+// out[i] = a[i] op b[i] over count words, returning the number of bits set in the result.
+// out may be nullptr when only the count is wanted.
+template <SetOperation op>
+std::uint64_t combineWordsScalar(const std::uint64_t* a, const std::uint64_t* b, std::uint64_t* out, std::size_t count)
+{
+	std::uint64_t bits{ 0 };
+	for(std::size_t i{ 0 }; i < count; ++i)
+	{
+		const std::uint64_t word{ combineWord<op>(a[i], b[i]) };
+		if(out)
+			out[i] = word;
+		bits += static_cast<std::uint64_t>(__builtin_popcountll(word));
+	}
+
+	return bits;
+}
+
+#ifdef ROARING_X86
+
+// AVX2 has no popcount instruction: look up the count of each nibble with a byte shuffle,
+// then sum the bytes of each 64-bit lane with sad against zero
+__attribute__((target("avx2")))
+inline __m256i popcountBytes(__m256i v)
+{
+	const __m256i lookup{ _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+					       0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4) };
+	const __m256i lowNibbles{ _mm256_set1_epi8(0x0F) };
+
+	const __m256i low{ _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, lowNibbles)) };
+	const __m256i high{ _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibbles)) };
+
+	return _mm256_add_epi8(low, high);
+}
+
+template <SetOperation op>
+__attribute__((target("avx2")))
+inline __m256i combineVector(__m256i a, __m256i b)
+{
+	if constexpr(op == SetOperation::intersect)
+		return _mm256_and_si256(a, b);
+	else if constexpr(op == SetOperation::subtract)
+		return _mm256_andnot_si256(b, a);
+	else
+		return _mm256_or_si256(a, b);
+}
+
+template <SetOperation op>
+__attribute__((target("avx2")))
+std::uint64_t combineWordsAvx2(const std::uint64_t* a, const std::uint64_t* b, std::uint64_t* out, std::size_t count)
+{
+	__m256i total{ _mm256_setzero_si256() };
+	std::size_t i{ 0 };
+	for(; i + 4 <= count; i += 4)
+	{
+		const __m256i word{ combineVector<op>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+						      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i))) };
+		if(out)
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), word);
+		total = _mm256_add_epi64(total, _mm256_sad_epu8(popcountBytes(word), _mm256_setzero_si256()));
+	}
+
+	alignas(32) std::uint64_t lanes[4]{};
+	_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), total);
+
+	return lanes[0] + lanes[1] + lanes[2] + lanes[3] + combineWordsScalar<op>(a + i, b + i, out ? out + i : nullptr, count - i);
+}
+
+#endif
+
+template <SetOperation op>
+std::uint64_t combineWords(const std::uint64_t* a, const std::uint64_t* b, std::uint64_t* out, std::size_t count)
+{
+#ifdef ROARING_X86
+	static const bool hasAvx2{ __builtin_cpu_supports("avx2") != 0 };
+	if(hasAvx2)
+		return combineWordsAvx2<op>(a, b, out, count);
+#endif
+
+	return combineWordsScalar<op>(a, b, out, count);
+}
+
+inline bool testBit(const std::vector<std::uint64_t>& words, std::uint16_t low)
+{
+	return (words[low >> 6] >> (low & 63)) & 1;
+}
+
+bool RoaringBitmap::Container::contains(std::uint16_t low) const
+{
+	if(isBitmap())
+		return testBit(bitmap, low);
+
+	return std::binary_search(array.begin(), array.end(), low);
+}
+
+void RoaringBitmap::Container::setWords(std::vector<std::uint64_t>&& words, std::uint32_t count)
+{
+	cardinality = count;
+	if(count > arrayLimit)
+	{
+		bitmap = std::move(words);
+		array.clear();
+		array.shrink_to_fit();
+		return;
+	}
+
+	std::vector<std::uint16_t> values{};
+	values.reserve(count);
+	for(std::size_t word{ 0 }; word < words.size(); ++word)
+	{
+		for(std::uint64_t bits{ words[word] }; bits != 0; bits &= bits - 1)
+			values.push_back(static_cast<std::uint16_t>(word * 64 + static_cast<std::size_t>(__builtin_ctzll(bits))));
+	}
+
+	array = std::move(values);
+	bitmap.clear();
+	bitmap.shrink_to_fit();
+}
+
+void RoaringBitmap::Container::setArray(std::vector<std::uint16_t>&& values)
+{
+	cardinality = static_cast<std::uint32_t>(values.size());
+	if(values.size() <= arrayLimit)
+	{
+		array = std::move(values);
+		bitmap.clear();
+		bitmap.shrink_to_fit();
+		return;
+	}
+
+	bitmap.assign(bitmapWords, 0);
+	for(std::uint16_t low : values)
+		bitmap[low >> 6] |= std::uint64_t{ 1 } << (low & 63);
+	array.clear();
+	array.shrink_to_fit();
+}
+
+RoaringBitmap::Container* RoaringBitmap::find(std::uint16_t key)
+{
+	const auto found{ std::lower_bound(m_containers.begin(), m_containers.end(), key,
+					   [](const Container& container, std::uint16_t k) { return container.key < k; }) };
+
+	return (found != m_containers.end() && found->key == key) ? &*found : nullptr;
+}
+
+const RoaringBitmap::Container* RoaringBitmap::find(std::uint16_t key) const
+{
+	return const_cast<RoaringBitmap*>(this)->find(key);
+}
+
+bool RoaringBitmap::add(std::uint32_t value)
+{
+	const auto key{ static_cast<std::uint16_t>(value >> 16) };
+	const auto low{ static_cast<std::uint16_t>(value) };
+
+	// values usually arrive in increasing order, so try the last container first
+	auto container{ (!m_containers.empty() && m_containers.back().key == key) ? m_containers.end() - 1
+		: std::lower_bound(m_containers.begin(), m_containers.end(), key,
+				   [](const Container& c, std::uint16_t k) { return c.key < k; }) };
+	if(container == m_containers.end() || container->key != key)
+	{
+		container = m_containers.insert(container, Container{});
+		container->key = key;
+	}
+
+	if(container->isBitmap())
+	{
+		std::uint64_t& word{ container->bitmap[low >> 6] };
+		const std::uint64_t bit{ std::uint64_t{ 1 } << (low & 63) };
+		if(word & bit)
+			return false;
+
+		word |= bit;
+		++container->cardinality;
+		return true;
+	}
+
+	std::vector<std::uint16_t>& array{ container->array };
+	const auto position{ (array.empty() || array.back() < low) ? array.end() : std::lower_bound(array.begin(), array.end(), low) };
+	if(position != array.end() && *position == low)
+		return false;
+
+	array.insert(position, low);
+	++container->cardinality;
+	if(array.size() > arrayLimit)
+		container->setArray(std::vector<std::uint16_t>{ std::move(array) });
+
+	return true;
+}
+
+bool RoaringBitmap::remove(std::uint32_t value)
+{
+	Container* container{ find(static_cast<std::uint16_t>(value >> 16)) };
+	const auto low{ static_cast<std::uint16_t>(value) };
+	if(!container || !container->contains(low))
+		return false;
+
+	if(container->isBitmap())
+	{
+		container->bitmap[low >> 6] &= ~(std::uint64_t{ 1 } << (low & 63));
+		if(--container->cardinality <= arrayLimit)
+			container->setWords(std::vector<std::uint64_t>{ std::move(container->bitmap) }, container->cardinality);
+	}
+	else
+	{
+		container->array.erase(std::lower_bound(container->array.begin(), container->array.end(), low));
+		--container->cardinality;
+	}
+
+	if(container->cardinality == 0)
+		m_containers.erase(m_containers.begin() + (container - m_containers.data()));
+
+	return true;
+}
+
+bool RoaringBitmap::contains(std::uint32_t value) const
+{
+	const Container* container{ find(static_cast<std::uint16_t>(value >> 16)) };
+
+	return container && container->contains(static_cast<std::uint16_t>(value));
+}
+
+std::uint64_t RoaringBitmap::cardinality() const
+{
+	std::uint64_t count{ 0 };
+	for(const Container& container : m_containers)
+		count += container.cardinality;
+
+	return count;
+}
+
+std::size_t RoaringBitmap::bitmapContainerCount() const
+{
+	return static_cast<std::size_t>(std::count_if(m_containers.begin(), m_containers.end(),
+						      [](const Container& container) { return container.isBitmap(); }));
+}
+
+std::size_t RoaringBitmap::memoryUsage() const
+{
+	std::size_t bytes{ m_containers.capacity() * sizeof(Container) };
+	for(const Container& container : m_containers)
+		bytes += container.array.capacity() * sizeof(std::uint16_t) + container.bitmap.capacity() * sizeof(std::uint64_t);
+
+	return bytes;
+}
+
+std::vector<std::uint32_t> RoaringBitmap::values() const
+{
+	std::vector<std::uint32_t> result{};
+	result.reserve(cardinality());
+	forEach([&result](std::uint32_t value) { result.push_back(value); });
+
+	return result;
+}
+
+struct RoaringOperations
+{
+	using Container = RoaringBitmap::Container;
+
+	// Combines two containers with the same key. With out == nullptr only counts the result.
+	template <SetOperation op>
+	static std::uint32_t combine(const Container& a, const Container& b, Container* out)
+	{
+		if(a.isBitmap() && b.isBitmap())
+		{
+			std::vector<std::uint64_t> words(out ? RoaringBitmap::bitmapWords : 0);
+			const auto count{ static_cast<std::uint32_t>(
+				combineWords<op>(a.bitmap.data(), b.bitmap.data(), out ? words.data() : nullptr, RoaringBitmap::bitmapWords)) };
+			if(out)
+				out->setWords(std::move(words), count);
+			return count;
+		}
+
+		if(!a.isBitmap() && !b.isBitmap())
+			return combineArrays<op>(a.array, b.array, out);
+
+		if constexpr(op == SetOperation::intersect)
+		{
+			// keep the array's values that the bitmap has
+			const Container& array{ a.isBitmap() ? b : a };
+			const Container& bitmap{ a.isBitmap() ? a : b };
+			return filterArray(array.array, bitmap.bitmap, true, out);
+		}
+		else if constexpr(op == SetOperation::subtract)
+		{
+			if(!a.isBitmap())
+				return filterArray(a.array, b.bitmap, false, out);
+
+			// bitmap minus array: clear the array's values in a copy of the bitmap
+			std::uint32_t count{ a.cardinality };
+			std::vector<std::uint64_t> words(out ? a.bitmap : std::vector<std::uint64_t>{});
+			for(std::uint16_t low : b.array)
+			{
+				if(!testBit(a.bitmap, low))
+					continue;
+				--count;
+				if(out)
+					words[low >> 6] &= ~(std::uint64_t{ 1 } << (low & 63));
+			}
+			if(out)
+				out->setWords(std::move(words), count);
+			return count;
+		}
+		else
+		{
+			// array into bitmap: set the array's values in a copy of the bitmap
+			const Container& array{ a.isBitmap() ? b : a };
+			const Container& bitmap{ a.isBitmap() ? a : b };
+			std::uint32_t count{ bitmap.cardinality };
+			std::vector<std::uint64_t> words(bitmap.bitmap);
+			for(std::uint16_t low : array.array)
+			{
+				std::uint64_t& word{ words[low >> 6] };
+				const std::uint64_t bit{ std::uint64_t{ 1 } << (low & 63) };
+				count += (word & bit) ? 0 : 1;
+				word |= bit;
+			}
+			if(out)
+				out->setWords(std::move(words), count);
+			return count;
+		}
+	}
+
+	template <SetOperation op>
+	static std::uint32_t combineArrays(const std::vector<std::uint16_t>& a, const std::vector<std::uint16_t>& b, Container* out)
+	{
+		std::vector<std::uint16_t> values{};
+		if constexpr(op == SetOperation::intersect)
+			std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(values));
+		else if constexpr(op == SetOperation::subtract)
+			std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(values));
+		else
+			std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(values));
+
+		const auto count{ static_cast<std::uint32_t>(values.size()) };
+		if(out)
+			out->setArray(std::move(values));
+		return count;
+	}
+
+	// The values of array that are (keep == true) or are not in bitmap
+	static std::uint32_t filterArray(const std::vector<std::uint16_t>& array, const std::vector<std::uint64_t>& bitmap, bool keep,
+					 Container* out)
+	{
+		std::vector<std::uint16_t> values{};
+		std::uint32_t count{ 0 };
+		for(std::uint16_t low : array)
+		{
+			if(testBit(bitmap, low) != keep)
+				continue;
+			++count;
+			if(out)
+				values.push_back(low);
+		}
+
+		if(out)
+			out->setArray(std::move(values));
+		return count;
+	}
+
+	// Walks both container lists in key order. With result == nullptr only counts.
+	template <SetOperation op>
+	static std::uint64_t apply(const RoaringBitmap& a, const RoaringBitmap& b, RoaringBitmap* result)
+	{
+		std::uint64_t count{ 0 };
+		auto keep{ [&](const Container& container)
+		{
+			count += container.cardinality;
+			if(result)
+				result->m_containers.push_back(container);
+		} };
+
+		auto first{ a.m_containers.begin() };
+		auto second{ b.m_containers.begin() };
+		while(first != a.m_containers.end() || second != b.m_containers.end())
+		{
+			if(second == b.m_containers.end() || (first != a.m_containers.end() && first->key < second->key))
+			{
+				if constexpr(op != SetOperation::intersect)
+					keep(*first);
+				++first;
+			}
+			else if(first == a.m_containers.end() || second->key < first->key)
+			{
+				if constexpr(op == SetOperation::unite)
+					keep(*second);
+				++second;
+			}
+			else
+			{
+				Container container{};
+				container.key = first->key;
+				const std::uint32_t combined{ combine<op>(*first, *second, result ? &container : nullptr) };
+				count += combined;
+				if(result && combined > 0)
+					result->m_containers.push_back(std::move(container));
+				++first;
+				++second;
+			}
+		}
+
+		return count;
+	}
+};
+
+RoaringBitmap intersect(const RoaringBitmap& a, const RoaringBitmap& b)
+{
+	RoaringBitmap result{};
+	RoaringOperations::apply<SetOperation::intersect>(a, b, &result);
+
+	return result;
+}
+
+RoaringBitmap subtract(const RoaringBitmap& a, const RoaringBitmap& b)
+{
+	RoaringBitmap result{};
+	RoaringOperations::apply<SetOperation::subtract>(a, b, &result);
+
+	return result;
+}
+
+RoaringBitmap unite(const RoaringBitmap& a, const RoaringBitmap& b)
+{
+	RoaringBitmap result{};
+	RoaringOperations::apply<SetOperation::unite>(a, b, &result);
+
+	return result;
+}
+
+std::uint64_t intersectCardinality(const RoaringBitmap& a, const RoaringBitmap& b)
+{
+	return RoaringOperations::apply<SetOperation::intersect>(a, b, nullptr);
+}
+
+std::uint64_t subtractCardinality(const RoaringBitmap& a, const RoaringBitmap& b)
+{
+	return RoaringOperations::apply<SetOperation::subtract>(a, b, nullptr);
+}
@@ -0,0 +1,87 @@
+#ifndef ROARING_H
+#define ROARING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+	// Compressed bitmap of 32-bit values in the Roaring layout: values are grouped by their high 16 bits,
+	// and each group (container) keeps its low 16 bits either as a sorted array, while it holds at most
+	// arrayLimit values, or as a 65536-bit bitmap. Sparse and dense ranges both stay small, and two
+	// bitmap containers combine 256 bits per AVX2 instruction.
+	class RoaringBitmap
+	{
+	public:
+		static constexpr std::size_t arrayLimit{ 4096 };       // 4096 16-bit values take as much as the bitmap
+		static constexpr std::size_t bitmapWords{ 65536 / 64 };
+
+	private:
+		struct Container
+		{
+			std::uint16_t key{};                    // high 16 bits of every value in the container
+			std::uint32_t cardinality{};
+			std::vector<std::uint16_t> array{};     // sorted low 16 bits while cardinality <= arrayLimit
+			std::vector<std::uint64_t> bitmap{};    // bitmapWords words otherwise
+
+			bool isBitmap() const { return !bitmap.empty(); }
+			bool contains(std::uint16_t low) const;
+
+			// Take over the result of an operation in whichever form suits its cardinality
+			void setWords(std::vector<std::uint64_t>&& words, std::uint32_t count);
+			void setArray(std::vector<std::uint16_t>&& values);
+		};
+
+		std::vector<Container> m_containers{};         // sorted by key, never empty
+
+		Container* find(std::uint16_t key);
+		const Container* find(std::uint16_t key) const;
+
+		friend struct RoaringOperations;           // the set operations in roaring.cpp
+
+	public:
+		// Returns false if the value was already present / absent
+		bool add(std::uint32_t value);
+		bool remove(std::uint32_t value);
+		bool contains(std::uint32_t value) const;
+
+		std::uint64_t cardinality() const;
+		bool empty() const { return m_containers.empty(); }
+
+		std::size_t containerCount() const { return m_containers.size(); }
+		std::size_t bitmapContainerCount() const;
+		std::size_t memoryUsage() const;                // bytes of container storage
+
+		std::vector<std::uint32_t> values() const;
+
+		template <typename Visitor>
+		void forEach(Visitor visit) const
+		{
+			for(const Container& container : m_containers)
+			{
+				const std::uint32_t high{ static_cast<std::uint32_t>(container.key) << 16 };
+				if(!container.isBitmap())
+				{
+					for(std::uint16_t low : container.array)
+						visit(high | low);
+					continue;
+				}
+
+				for(std::size_t word{ 0 }; word < bitmapWords; ++word)
+				{
+					for(std::uint64_t bits{ container.bitmap[word] }; bits != 0; bits &= bits - 1)
+						visit(high | static_cast<std::uint32_t>(word * 64 + static_cast<std::size_t>(__builtin_ctzll(bits))));
+				}
+			}
+		}
+	};
+
+	// a & b, a & ~b and a | b
+	RoaringBitmap intersect(const RoaringBitmap& a, const RoaringBitmap& b);
+	RoaringBitmap subtract(const RoaringBitmap& a, const RoaringBitmap& b);
+	RoaringBitmap unite(const RoaringBitmap& a, const RoaringBitmap& b);
+
+	// The cardinality of the same results, without building them
+	std::uint64_t intersectCardinality(const RoaringBitmap& a, const RoaringBitmap& b);
+	std::uint64_t subtractCardinality(const RoaringBitmap& a, const RoaringBitmap& b);
+
+#endif
@@ -4,12 +4,25 @@
 // If an invalid operator is passed into the function, the function should print an error.
 // For the division operator, do an integer division.
 
+// calculate() takes any integer type; main() uses BigInt from 12_Functions/009_bigint so results never overflow.
+// A zero divisor prints an error and gives 0 instead of undefined behavior.
+// calculate() goes through CachedEvaluator (12_Functions/008_calc/result_cache.h) with caching off: it prints errors
+// and asks for another operator, so a cached answer would skip that I/O, and one query per run never hits anyway.
+
+// Build: g++ -std=c++17 000_switch_calc.cpp ../12_Functions/009_bigint/bigint.cpp
+
+#include "../12_Functions/008_calc/result_cache.h"
+#include "../12_Functions/009_bigint/bigint.h"
 #include <iostream>
 
-int getInt()
+using Integer = BigInt;
+
+constexpr bool cacheResults{ false };
+
+Integer getInt()
 {
 	std::cout << "Enter an integer: ";
-	int input{};
+	Integer input{};
 	std::cin >> input;
 
 	return input;
@@ -24,8 +37,15 @@ char getOp()
 	return op;
 }
 
-int calculate(int x, int y, char op)
+template <typename T>
+T calculate(T x, T y, char op)
 {
+	if((op == '/' || op == '%') && y == 0)
+	{
+		std::cout << "Division by zero.\n";
+		return T{ 0 };
+	}
+
 	switch(op)
 	{
 		case '+':
@@ -49,11 +69,13 @@ int calculate(int x, int y, char op)
 
 int main()
 {
-	int x{ getInt() };
-	int y{ getInt() };
+	Integer x{ getInt() };
+	Integer y{ getInt() };
 	char op{ getOp() };
 
-	std::cout << calculate( x, y, op);
+	CalcCache<cacheResults, Integer, Integer, char> cache{ 1024 };
+	CachedEvaluator evaluator{ cache, [](const Integer& a, char o, const Integer& b) { return calculate(a, b, o); } };
+	std::cout << evaluator(x, op, y);
 
 	return 0;
 }
@@ -0,0 +1,174 @@
+#include "batch.h"
+#include "bitmap_file.h"
+#include "primality.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Bytes read per block; every complete line in a block is classified together
+constexpr std::size_t blockSize{ 4 << 20 };
+
+// Entries per pool task within a block
+constexpr std::size_t entriesPerTask{ 16 * 1024 };
+
+constexpr std::size_t outputFlushSize{ 1 << 20 };
+
+enum class EntryKind : unsigned char
+{
+	invalid,
+	prime,
+	not_prime,
+};
+
+struct Entry
+{
+	const char* text{};
+	std::size_t length{};
+	std::uint64_t value{};
+	EntryKind kind{ EntryKind::invalid };
+};
+
+// Splits buffer[0, size) into entries, one per non-blank line
+void parseLines(const char* begin, const char* end, std::vector<Entry>& entries)
+{
+	while(begin < end)
+	{
+		const char* lineEnd{ static_cast<const char*>(std::memchr(begin, '\n', static_cast<std::size_t>(end - begin))) };
+		if(!lineEnd)
+			lineEnd = end;
+
+		const char* textEnd{ lineEnd };
+		while(textEnd > begin && (textEnd[-1] == '\r' || textEnd[-1] == ' ' || textEnd[-1] == '\t'))
+			--textEnd;
+		const char* text{ begin };
+		while(text < textEnd && (*text == ' ' || *text == '\t'))
+			++text;
+
+		if(text < textEnd)
+		{
+			Entry entry{ text, static_cast<std::size_t>(textEnd - text) };
+			const auto [ptr, ec]{ std::from_chars(text, textEnd, entry.value) };
+			entry.kind = (ec == std::errc{} && ptr == textEnd) ? EntryKind::not_prime : EntryKind::invalid;
+			entries.push_back(entry);
+		}
+
+		begin = lineEnd + 1;
+	}
+}
+
+void classifyEntries(Entry* first, Entry* last, const MappedPrimeBitmap* bitmap)
+{
+	const std::uint64_t bitmapLimit{ bitmap ? bitmap->limit() : 0 };
+	for(; first != last; ++first)
+	{
+		if(first->kind == EntryKind::invalid)
+			continue;
+
+		const std::uint64_t n{ first->value };
+		if(n < bitmapLimit ? bitmap->isPrime(n) : isPrime(n))
+			first->kind = EntryKind::prime;
+	}
+}
+
+void classifyBlock(std::vector<Entry>& entries, ThreadPool* pool, const MappedPrimeBitmap* bitmap)
+{
+	if(!pool || entries.size() <= entriesPerTask)
+	{
+		classifyEntries(entries.data(), entries.data() + entries.size(), bitmap);
+		return;
+	}
+
+	for(std::size_t first{ 0 }; first < entries.size(); first += entriesPerTask)
+	{
+		Entry* begin{ entries.data() + first };
+		Entry* end{ entries.data() + std::min(entries.size(), first + entriesPerTask) };
+		pool->submit([begin, end, bitmap] { classifyEntries(begin, end, bitmap); }, static_cast<std::uint64_t>(end - begin));
+	}
+	pool->wait();
+}
+
+void writeEntries(const std::vector<Entry>& entries, std::string& output, std::FILE* out, BatchStats& stats)
+{
+	for(const Entry& entry : entries)
+	{
+		++stats.lines;
+		switch(entry.kind)
+		{
+			case EntryKind::prime:
+				++stats.primes;
+				[[fallthrough]];
+			case EntryKind::not_prime:
+			{
+				char digits[24]{};
+				output.append(digits, std::to_chars(digits, digits + sizeof(digits), entry.value).ptr);
+				output.append(entry.kind == EntryKind::prime ? " prime\n" : " not prime\n");
+				break;
+			}
+			case EntryKind::invalid:
+				++stats.invalid;
+				output.append(entry.text, entry.length);
+				output.append(" invalid\n");
+				break;
+		}
+
+		if(output.size() >= outputFlushSize)
+		{
+			std::fwrite(output.data(), 1, output.size(), out);
+			output.clear();
+		}
+	}
+}
+
+BatchStats classifyStream(std::FILE* in, std::FILE* out, ThreadPool* pool, const MappedPrimeBitmap* bitmap)
+{
+	BatchStats stats{};
+	std::vector<char> buffer(blockSize);
+	std::vector<Entry> entries{};
+	std::string output{};
+	output.reserve(outputFlushSize + 64);
+
+	std::size_t carried{ 0 };       // bytes of an unfinished line kept from the previous block
+	while(true)
+	{
+		if(carried == buffer.size())
+			buffer.resize(buffer.size() * 2);       // a single line longer than the whole buffer
+
+		const std::size_t read{ std::fread(buffer.data() + carried, 1, buffer.size() - carried, in) };
+		const std::size_t filled{ carried + read };
+		const bool atEnd{ read == 0 };
+		if(filled == 0)
+			break;
+
+		// everything up to the last newline is complete; at end of input the rest is a final line
+		const char* begin{ buffer.data() };
+		const char* end{ begin + filled };
+		const char* complete{ end };
+		if(!atEnd)
+		{
+			while(complete > begin && complete[-1] != '\n')
+				--complete;
+		}
+
+		entries.clear();
+		parseLines(begin, complete, entries);
+		classifyBlock(entries, pool, bitmap);
+		writeEntries(entries, output, out, stats);
+
+		carried = static_cast<std::size_t>(end - complete);
+		std::memmove(buffer.data(), complete, carried);
+		if(atEnd)
+			break;
+	}
+
+	std::fwrite(output.data(), 1, output.size(), out);
+	std::fflush(out);
+
+	return stats;
+}
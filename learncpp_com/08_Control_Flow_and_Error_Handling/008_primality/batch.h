@@ -0,0 +1,23 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "bitmap_file.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <cstdio>
+
+	struct BatchStats
+	{
+		std::uint64_t lines{};
+		std::uint64_t primes{};
+		std::uint64_t invalid{};
+	};
+
+	// Reads newline-separated integers from in and writes one line per input to out:
+	// "<n> prime", "<n> not prime" or "<text> invalid" (anything that is not a number in [0, 2^64)).
+	// Blank lines are skipped. With a pool each block is classified in parallel; output order always matches input.
+	// With a bitmap, numbers below its limit are looked up there instead of tested.
+	BatchStats classifyStream(std::FILE* in, std::FILE* out, ThreadPool* pool = nullptr,
+				  const MappedPrimeBitmap* bitmap = nullptr);
+
+#endif
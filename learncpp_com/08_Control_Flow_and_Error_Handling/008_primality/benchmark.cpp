@@ -0,0 +1,118 @@
+// Compare the segmented sieve against trial division, then time the sieve on a large range.
+// Check single-number Miller-Rabin queries against the sieve and time them up to 2^64.
+// Usage: benchmark [lo hi]    (default range: [1e11, 1e11 + 1e9])
+
+// Build: g++ -std=c++17 -O2 benchmark.cpp primality.cpp sieve.cpp trial_division.cpp
+
+#include "primality.h"
+#include "sieve.h"
+#include "timer.h"
+#include "trial_division.h"
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+void compareWithTrialDivision(int limit)
+{
+	Timer timer{};
+	std::uint64_t trialCount{ 0 };
+	for(int n{ 0 }; n <= limit; ++n)
+	{
+		if(isPrimeTrialDivision(n))
+			++trialCount;
+	}
+	const double trialSeconds{ timer.elapsed() };
+
+	timer.reset();
+	const std::uint64_t sieveCount{ countPrimes(0, static_cast<std::uint64_t>(limit)) };
+	const double sieveSeconds{ timer.elapsed() };
+
+	std::cout << "pi(" << limit << "): trial division " << trialCount << " in " << trialSeconds << " s, "
+		  << "sieve " << sieveCount << " in " << sieveSeconds << " s"
+		  << (trialCount == sieveCount ? "" : "  MISMATCH") << '\n';
+}
+
+void compareWithSieve(std::uint64_t lo, std::uint64_t hi)
+{
+	const auto primes{ primesInRange(lo, hi) };
+
+	Timer timer{};
+	std::uint64_t mismatches{ 0 };
+	std::size_t next{ 0 };
+	for(std::uint64_t n{ lo }; n <= hi; ++n)
+	{
+		const bool expected{ next < primes.size() && primes[next] == n };
+		if(expected)
+			++next;
+		if(isPrime(n) != expected)
+			++mismatches;
+	}
+
+	std::cout << "isPrime over [" << lo << ", " << hi << "]: " << mismatches << " mismatches against the sieve, "
+		  << timer.elapsed() * 1e9 / static_cast<double>(hi - lo + 1) << " ns per query\n";
+}
+
+void timeLargeQueries(int count)
+{
+	std::mt19937_64 mt{ 12345 };
+	std::vector<std::uint64_t> inputs(static_cast<std::size_t>(count));
+	for(auto& n : inputs)
+		n = mt() | 1 | (1ULL << 63);
+
+	Timer timer{};
+	int primeCount{ 0 };
+	for(std::uint64_t n : inputs)
+	{
+		if(isPrime(n))
+			++primeCount;
+	}
+	const double randomSeconds{ timer.elapsed() };
+
+	// the worst case: primes just below 2^64 run every witness
+	constexpr std::uint64_t largestPrime{ 18'446'744'073'709'551'557ULL };
+	timer.reset();
+	int largestCount{ 0 };
+	for(int i{ 0 }; i < count; ++i)
+	{
+		if(isPrime(largestPrime))
+			++largestCount;
+	}
+	const double largestSeconds{ timer.elapsed() };
+
+	std::cout << "isPrime on random odd 64-bit numbers: " << primeCount << " primes, "
+		  << randomSeconds * 1e6 / count << " us per query\n"
+		  << "isPrime(2^64 - 59): " << (largestCount == count ? "prime" : "WRONG") << ", "
+		  << largestSeconds * 1e6 / count << " us per query\n";
+}
+
+int main(int argc, char* argv[])
+{
+	std::uint64_t lo{ 100'000'000'000 };
+	std::uint64_t hi{ lo + 1'000'000'000 };
+	if(argc == 3)
+	{
+		lo = std::stoull(argv[1]);
+		hi = std::stoull(argv[2]);
+	}
+
+	for(int limit : { 1'000, 10'000, 30'000 })
+		compareWithTrialDivision(limit);
+
+	Timer timer{};
+	const std::uint64_t count{ countPrimes(lo, hi) };
+	std::cout << "countPrimes(" << lo << ", " << hi << ") = " << count
+		  << " in " << timer.elapsed() << " s\n";
+
+	timer.reset();
+	const auto primes{ primesInRange(lo, hi) };
+	std::cout << "primesInRange(" << lo << ", " << hi << ") returned " << primes.size()
+		  << " primes in " << timer.elapsed() << " s\n";
+
+	compareWithSieve(0, 2'000'000);
+	compareWithSieve(lo, lo + 2'000'000);
+	timeLargeQueries(100'000);
+
+	return 0;
+}
@@ -0,0 +1,204 @@
+#include "bitmap_file.h"
+#include "parallel_sieve.h"
+#include "prime_table.h"
+#include "sieve.h"
+#include "thread_pool.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+std::uint64_t fnv1a(const std::uint8_t* bytes, std::uint64_t count)
+{
+	std::uint64_t hash{ 0xcbf2'9ce4'8422'2325 };
+	for(std::uint64_t i{ 0 }; i < count; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 0x0000'0100'0000'01B3;
+	}
+
+	return hash;
+}
+
+std::string systemError(const std::string& what, const std::string& path)
+{
+	return what + " " + path + ": " + std::strerror(errno);
+}
+
+bool writePrimeBitmap(const std::string& path, std::uint64_t limit, ThreadPool& pool, std::string& error)
+{
+	if(limit < 30 || limit >= maxSieveBound)
+	{
+		error = "limit must be between 30 and 2^62";
+		return false;
+	}
+
+	const std::uint64_t byteCount{ (limit + 29) / 30 };
+	const std::uint64_t fileSize{ sizeof(BitmapFileHeader) + byteCount };
+
+	// write to a temporary name and rename at the end, so readers never map a half-written file
+	const std::string temporaryPath{ path + ".tmp" };
+	const int fd{ ::open(temporaryPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644) };
+	if(fd < 0)
+	{
+		error = systemError("Can not create", temporaryPath);
+		return false;
+	}
+
+	if(::ftruncate(fd, static_cast<off_t>(fileSize)) != 0)
+	{
+		error = systemError("Can not resize", temporaryPath);
+		::close(fd);
+		::unlink(temporaryPath.c_str());
+		return false;
+	}
+
+	void* mapping{ ::mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) };
+	::close(fd);
+	if(mapping == MAP_FAILED)
+	{
+		error = systemError("Can not map", temporaryPath);
+		::unlink(temporaryPath.c_str());
+		return false;
+	}
+
+	auto* header{ static_cast<BitmapFileHeader*>(mapping) };
+	auto* bits{ static_cast<std::uint8_t*>(mapping) + sizeof(BitmapFileHeader) };
+
+	// the file starts zeroed, so only primes need setting; 2, 3 and 5 are off the wheel.
+	// Chunks arrive in ascending order on this thread, so the writes never race.
+	parallelForEachPrime(7, limit - 1, pool, [bits](const std::vector<std::uint64_t>& primes)
+	{
+		for(std::uint64_t p : primes)
+			bits[p / 30] |= wheelBit[p % 30];
+	}, 30 << 20);
+
+	BitmapFileHeader filled{};
+	std::memcpy(filled.magic, bitmapMagic, sizeof(filled.magic));
+	filled.version = bitmapVersion;
+	filled.byteOrderMark = bitmapByteOrderMark;
+	filled.wheel = 30;
+	filled.headerSize = sizeof(BitmapFileHeader);
+	filled.limit = limit;
+	filled.byteCount = byteCount;
+	filled.checksum = fnv1a(bits, byteCount);
+	*header = filled;
+
+	const bool synced{ ::msync(mapping, fileSize, MS_SYNC) == 0 };
+	::munmap(mapping, fileSize);
+	if(!synced)
+	{
+		error = systemError("Can not write", temporaryPath);
+		::unlink(temporaryPath.c_str());
+		return false;
+	}
+
+	if(std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+	{
+		error = systemError("Can not rename to", path);
+		::unlink(temporaryPath.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+MappedPrimeBitmap::~MappedPrimeBitmap()
+{
+	close();
+}
+
+void MappedPrimeBitmap::close()
+{
+	if(m_mapping)
+		::munmap(m_mapping, m_mappingSize);
+
+	m_bits = nullptr;
+	m_limit = 0;
+	m_checksum = 0;
+	m_mapping = nullptr;
+	m_mappingSize = 0;
+}
+
+bool MappedPrimeBitmap::open(const std::string& path, std::string& error)
+{
+	close();
+	error.clear();
+
+	const int fd{ ::open(path.c_str(), O_RDONLY) };
+	if(fd < 0)
+	{
+		error = systemError("Can not open", path);
+		return false;
+	}
+
+	struct stat status{};
+	if(::fstat(fd, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(BitmapFileHeader)))
+	{
+		error = path + " is too small to be a prime bitmap";
+		::close(fd);
+		return false;
+	}
+
+	const auto size{ static_cast<std::size_t>(status.st_size) };
+	void* mapping{ ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) };
+	::close(fd);
+	if(mapping == MAP_FAILED)
+	{
+		error = systemError("Can not map", path);
+		return false;
+	}
+
+	BitmapFileHeader header{};
+	std::memcpy(&header, mapping, sizeof(header));
+
+	if(std::memcmp(header.magic, bitmapMagic, sizeof(header.magic)) != 0)
+		error = path + " is not a prime bitmap";
+	else if(header.version != bitmapVersion)
+		error = path + " has unsupported version " + std::to_string(header.version);
+	else if(header.byteOrderMark != bitmapByteOrderMark)
+		error = path + " was written on a machine with a different byte order";
+	// every size is checked against the file before it is used in arithmetic, so nothing can wrap
+	else if(header.wheel != 30 || header.headerSize < sizeof(BitmapFileHeader) || header.headerSize > size
+		|| header.limit < 30 || header.limit >= maxSieveBound
+		|| header.byteCount != (header.limit + 29) / 30 || size - header.headerSize < header.byteCount)
+		error = path + " has an inconsistent header";
+
+	if(!error.empty())
+	{
+		::munmap(mapping, size);
+		return false;
+	}
+
+	// lookups jump around the file; reading ahead would only evict other pages
+	::madvise(mapping, size, MADV_RANDOM);
+
+	m_mapping = mapping;
+	m_mappingSize = size;
+	m_bits = static_cast<const std::uint8_t*>(mapping) + header.headerSize;
+	m_limit = header.limit;
+	m_checksum = header.checksum;
+
+	return true;
+}
+
+bool MappedPrimeBitmap::isPrime(std::uint64_t n) const
+{
+	if(n < 30)
+		return isPrimeSmall(static_cast<std::uint32_t>(n));
+
+	return m_bits[n / 30] & wheelBit[n % 30];
+}
+
+bool MappedPrimeBitmap::checksumMatches() const
+{
+	return isOpen() && fnv1a(m_bits, (m_limit + 29) / 30) == m_checksum;
+}
@@ -0,0 +1,67 @@
+#ifndef BITMAP_FILE_H
+#define BITMAP_FILE_H
+
+#include "thread_pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+	// On-disk prime bitmap with the same mod-30 wheel layout as prime_table.h:
+	// a 64-byte header followed by one byte per 30 numbers, bit i of byte q set when 30 * q + wheelResidues[i] is prime.
+	// Integers are stored in the byte order of the machine that wrote the file; a reader rejects a mismatch.
+
+	inline constexpr char bitmapMagic[8]{ 'P', 'R', 'I', 'M', 'E', 'B', 'M', 'P' };
+	inline constexpr std::uint32_t bitmapVersion{ 1 };
+	inline constexpr std::uint32_t bitmapByteOrderMark{ 0x0102'0304 };
+
+	struct BitmapFileHeader
+	{
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t byteOrderMark;
+		std::uint32_t wheel;            // always 30
+		std::uint32_t headerSize;       // offset of the bitmap bytes
+		std::uint64_t limit;            // numbers below limit are covered
+		std::uint64_t byteCount;        // limit / 30 rounded up
+		std::uint64_t checksum;         // FNV-1a over the bitmap bytes
+		std::uint8_t reserved[16];
+	};
+
+	static_assert(sizeof(BitmapFileHeader) == 64);
+
+	// Sieves [0, limit) on the pool and writes the file. Returns false and sets error on failure.
+	bool writePrimeBitmap(const std::string& path, std::uint64_t limit, ThreadPool& pool, std::string& error);
+
+	// Read-only view of a bitmap file. Opening maps the file and checks the header only,
+	// so it costs the same for any size; pages are loaded on first touch and shared through the page cache
+	// by every process that maps the same file. Lookups take no locks and never write.
+	class MappedPrimeBitmap
+	{
+	private:
+		const std::uint8_t* m_bits{ nullptr };
+		std::uint64_t m_limit{ 0 };
+		std::uint64_t m_checksum{ 0 };
+		void* m_mapping{ nullptr };
+		std::size_t m_mappingSize{ 0 };
+
+	public:
+		MappedPrimeBitmap() = default;
+		~MappedPrimeBitmap();
+
+		MappedPrimeBitmap(const MappedPrimeBitmap&) = delete;
+		MappedPrimeBitmap& operator=(const MappedPrimeBitmap&) = delete;
+
+		bool open(const std::string& path, std::string& error);
+		void close();
+
+		bool isOpen() const { return m_bits != nullptr; }
+		std::uint64_t limit() const { return m_limit; }
+
+		// n must be below limit()
+		bool isPrime(std::uint64_t n) const;
+
+		// Reads every page, so only for tools and tests
+		bool checksumMatches() const;
+	};
+
+#endif
@@ -0,0 +1,226 @@
+#include "factor.h"
+#include "prime_table.h"
+#include "primality.h"
+#include "thread_pool.h"
+#include "../../05_Operators/002_pow/powmod.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Odd primes below this are removed by trial division before Pollard rho starts
+constexpr std::uint32_t trialDivisionBound{ 1 << 12 };
+
+// Pollard rho multiplies this many differences together before taking one gcd
+constexpr int gcdBatchSize{ 128 };
+
+constexpr std::size_t countOddSmallPrimes()
+{
+	std::size_t count{ 0 };
+	for(std::uint32_t n{ 3 }; n < trialDivisionBound; n += 2)
+	{
+		if(isPrimeSmall(n))
+			++count;
+	}
+
+	return count;
+}
+
+// For an odd prime p, n is divisible by p exactly when n * inverse (mod 2^64) <= maxQuotient,
+// and then that product is n / p. One multiply and one compare instead of a division.
+struct TrialPrime
+{
+	std::uint64_t prime{};
+	std::uint64_t inverse{};        // p^-1 mod 2^64
+	std::uint64_t maxQuotient{};    // (2^64 - 1) / p
+};
+
+using TrialPrimes = std::array<TrialPrime, countOddSmallPrimes()>;
+
+constexpr TrialPrimes makeTrialPrimes()
+{
+	TrialPrimes primes{};
+	std::size_t i{ 0 };
+	for(std::uint32_t n{ 3 }; n < trialDivisionBound; n += 2)
+	{
+		if(!isPrimeSmall(n))
+			continue;
+
+		std::uint64_t inverse{ n };
+		for(int step{ 0 }; step < 6; ++step)
+			inverse *= 2 - n * inverse;
+
+		primes[i++] = { n, inverse, ~std::uint64_t{ 0 } / n };
+	}
+
+	return primes;
+}
+
+constexpr TrialPrimes trialPrimes{ makeTrialPrimes() };
+
+std::uint64_t binaryGcd(std::uint64_t a, std::uint64_t b)
+{
+	if(a == 0 || b == 0)
+		return a | b;
+
+	const int shift{ __builtin_ctzll(a | b) };
+	a >>= __builtin_ctzll(a);
+	while(b)
+	{
+		b >>= __builtin_ctzll(b);
+		if(a > b)
+			std::swap(a, b);
+		b -= a;
+	}
+
+	return a << shift;
+}
+
+// Brent's variant of Pollard rho on x -> x^2 + c, in Montgomery form. n must be odd and composite.
+// Returns a non-trivial factor of n.
+std::uint64_t pollardBrent(std::uint64_t n)
+{
+	const Montgomery64 montgomery{ n };
+
+	auto addMod{ [n](std::uint64_t a, std::uint64_t b)
+	{
+		const std::uint64_t sum{ a + b };
+		return (sum >= n || sum < a) ? sum - n : sum;
+	} };
+	auto distance{ [](std::uint64_t a, std::uint64_t b) { return a > b ? a - b : b - a; } };
+
+	for(std::uint64_t c{ 1 }; ; ++c)
+	{
+		const std::uint64_t increment{ montgomery.toMontgomery(c) };
+		auto step{ [&](std::uint64_t x) { return addMod(montgomery.multiply(x, x), increment); } };
+
+		std::uint64_t y{ montgomery.toMontgomery(2) };
+		std::uint64_t x{ y };
+		std::uint64_t saved{ y };
+		std::uint64_t product{ montgomery.one() };
+		std::uint64_t g{ 1 };
+
+		for(std::uint64_t length{ 1 }; g == 1; length *= 2)
+		{
+			x = y;
+			for(std::uint64_t i{ 0 }; i < length; ++i)
+				y = step(y);
+
+			for(std::uint64_t done{ 0 }; done < length && g == 1; done += gcdBatchSize)
+			{
+				saved = y;
+				const std::uint64_t batch{ std::min<std::uint64_t>(gcdBatchSize, length - done) };
+				for(std::uint64_t i{ 0 }; i < batch; ++i)
+				{
+					y = step(y);
+					product = montgomery.multiply(product, distance(x, y));
+				}
+
+				// product is in Montgomery form, i.e. times 2^64; that factor is coprime to odd n
+				g = binaryGcd(product, n);
+			}
+		}
+
+		if(g == n)
+		{
+			// the batch overshot: replay it one difference at a time
+			do
+			{
+				saved = step(saved);
+				g = binaryGcd(distance(x, saved), n);
+			}
+			while(g == 1);
+		}
+
+		if(g != n)
+			return g;
+		// this cycle closed without splitting n; try another constant
+	}
+}
+
+void factorizeLarge(std::uint64_t n, std::vector<std::uint64_t>& factors)
+{
+	if(n == 1)
+	{
+		return;
+	}
+
+	if(isPrime(n))
+	{
+		factors.push_back(n);
+		return;
+	}
+
+	const std::uint64_t divisor{ pollardBrent(n) };
+	factorizeLarge(divisor, factors);
+	factorizeLarge(n / divisor, factors);
+}
+
+std::vector<std::uint64_t> factorize(std::uint64_t n)
+{
+	std::vector<std::uint64_t> factors{};
+	if(n < 2)
+	{
+		return factors;
+	}
+
+	const int twos{ __builtin_ctzll(n) };
+	factors.insert(factors.end(), static_cast<std::size_t>(twos), 2);
+	n >>= twos;
+
+	for(const TrialPrime& p : trialPrimes)
+	{
+		if(p.prime * p.prime > n)
+			break;
+
+		for(std::uint64_t quotient{ n * p.inverse }; quotient <= p.maxQuotient; quotient = n * p.inverse)
+		{
+			factors.push_back(p.prime);
+			n = quotient;
+		}
+	}
+
+	// every factor left is at least trialDivisionBound, so a small remainder is prime
+	if(n < static_cast<std::uint64_t>(trialDivisionBound) * trialDivisionBound)
+	{
+		if(n > 1)
+			factors.push_back(n);
+
+		return factors;
+	}
+
+	const std::size_t large{ factors.size() };
+	factorizeLarge(n, factors);
+	std::sort(factors.begin() + static_cast<std::ptrdiff_t>(large), factors.end());
+
+	return factors;
+}
+
+std::vector<std::vector<std::uint64_t>> factorizeBatch(const std::vector<std::uint64_t>& inputs, ThreadPool* pool)
+{
+	std::vector<std::vector<std::uint64_t>> results(inputs.size());
+	if(!pool)
+	{
+		for(std::size_t i{ 0 }; i < inputs.size(); ++i)
+			results[i] = factorize(inputs[i]);
+
+		return results;
+	}
+
+	// semiprime costs vary a lot, so hand out small slices and let idle workers steal
+	constexpr std::size_t inputsPerTask{ 64 };
+	for(std::size_t first{ 0 }; first < inputs.size(); first += inputsPerTask)
+	{
+		const std::size_t last{ std::min(inputs.size(), first + inputsPerTask) };
+		pool->submit([&inputs, &results, first, last]
+		{
+			for(std::size_t i{ first }; i < last; ++i)
+				results[i] = factorize(inputs[i]);
+		}, last - first);
+	}
+	pool->wait();
+
+	return results;
+}
@@ -0,0 +1,16 @@
+#ifndef FACTOR_H
+#define FACTOR_H
+
+#include "thread_pool.h"
+#include <cstdint>
+#include <vector>
+
+	// Prime factors of n in ascending order, repeated by multiplicity (factorize(12) is { 2, 2, 3 }).
+	// 0 and 1 have no prime factors and give an empty list.
+	std::vector<std::uint64_t> factorize(std::uint64_t n);
+
+	// factorize() for every input; with a pool the inputs are spread over its workers
+	std::vector<std::vector<std::uint64_t>> factorizeBatch(const std::vector<std::uint64_t>& inputs,
+							       ThreadPool* pool = nullptr);
+
+#endif
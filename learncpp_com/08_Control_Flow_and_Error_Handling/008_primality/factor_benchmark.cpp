@@ -0,0 +1,105 @@
+// Factor random semiprimes (and a mix of random 64-bit numbers), check every result,
+// and time the single-number and the batch API.
+// Usage: factor_benchmark [--threads N] [count]
+
+// Build: g++ -std=c++17 -O2 -pthread factor_benchmark.cpp factor.cpp primality.cpp thread_pool.cpp
+
+#include "factor.h"
+#include "primality.h"
+#include "thread_pool.h"
+#include "timer.h"
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+std::uint64_t randomPrime(std::mt19937_64& mt, int bits)
+{
+	while(true)
+	{
+		const std::uint64_t candidate{ (mt() >> (64 - bits)) | (std::uint64_t{ 1 } << (bits - 1)) | 1 };
+		if(isPrime(candidate))
+			return candidate;
+	}
+}
+
+bool isValidFactorization(std::uint64_t n, const std::vector<std::uint64_t>& factors)
+{
+	unsigned __int128 product{ 1 };
+	std::uint64_t previous{ 0 };
+	for(std::uint64_t p : factors)
+	{
+		if(p < previous || !isPrime(p))
+			return false;
+
+		product *= p;
+		previous = p;
+	}
+
+	return n < 2 ? factors.empty() : product == n;
+}
+
+void run(const std::string& name, const std::vector<std::uint64_t>& inputs, ThreadPool& pool)
+{
+	int invalid{ 0 };
+	Timer timer{};
+	for(std::uint64_t n : inputs)
+	{
+		if(!isValidFactorization(n, factorize(n)))
+			++invalid;
+	}
+	const double singleSeconds{ timer.elapsed() };
+
+	timer.reset();
+	const auto results{ factorizeBatch(inputs, &pool) };
+	const double batchSeconds{ timer.elapsed() };
+	for(std::size_t i{ 0 }; i < inputs.size(); ++i)
+	{
+		if(!isValidFactorization(inputs[i], results[i]))
+			++invalid;
+	}
+
+	std::cout << name << ": " << inputs.size() << " inputs, " << invalid << " invalid, "
+		  << singleSeconds * 1e6 / inputs.size() << " us each with factorize() (including the check), "
+		  << batchSeconds * 1e6 / inputs.size() << " us each with factorizeBatch() on " << pool.size() << " threads\n";
+}
+
+int main(int argc, char* argv[])
+{
+	std::size_t threads{ std::thread::hardware_concurrency() };
+	std::size_t count{ 2'000 };
+	for(int i{ 1 }; i < argc; ++i)
+	{
+		const std::string arg{ argv[i] };
+		if(arg == "--threads" && i + 1 < argc)
+			threads = std::stoul(argv[++i]);
+		else
+			count = std::stoul(arg);
+	}
+
+	ThreadPool pool{ threads == 0 ? 1 : threads };
+	std::mt19937_64 mt{ 31337 };
+
+	for(int bits : { 16, 24, 32 })
+	{
+		std::vector<std::uint64_t> semiprimes(count);
+		for(auto& n : semiprimes)
+			n = randomPrime(mt, bits) * randomPrime(mt, 64 - bits);
+
+		run(std::to_string(bits) + "-bit x " + std::to_string(64 - bits) + "-bit semiprimes", semiprimes, pool);
+	}
+
+	std::vector<std::uint64_t> mixed(count);
+	for(auto& n : mixed)
+		n = mt();
+	mixed[0] = 0;
+	mixed[1] = 1;
+	mixed[2] = ~std::uint64_t{ 0 };
+	mixed[3] = 4'294'967'291ULL * 4'294'967'291ULL;         // square of the largest 32-bit prime
+	mixed[4] = std::uint64_t{ 1 } << 63;
+	run("random 64-bit numbers", mixed, pool);
+
+	return 0;
+}
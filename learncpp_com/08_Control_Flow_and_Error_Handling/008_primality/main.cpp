@@ -0,0 +1,144 @@
+// Usage: main [--bitmap path]                                 interactive, one number
+//        main --batch [file] [--threads N] [--bitmap path]    classify newline-separated integers from file or stdin
+// --bitmap maps a file written by make_bitmap and answers numbers below its limit from it.
+
+// Build: g++ -std=c++17 -O2 -pthread main.cpp batch.cpp bitmap_file.cpp factor.cpp parallel_sieve.cpp primality.cpp sieve.cpp thread_pool.cpp
+
+#include "batch.h"
+#include "bitmap_file.h"
+#include "factor.h"
+#include "primality.h"
+#include "thread_pool.h"
+#include "timer.h"
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+
+// Get user input, anything from 0 up to 2^64 - 1
+bool getNumber(std::uint64_t& input)
+{
+	std::cout << "Enter a positive integer: ";
+	std::cin >> std::ws;
+
+	if(std::cin.peek() != '-' && std::cin >> input)
+	{
+		return true;
+	}
+
+	if(std::cin.eof())
+	{
+		return false;
+	}
+
+	std::cin.clear();
+	std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+	return false;
+}
+
+// Print whether the number is prime, and its factorization when it is not
+void printAnswer(std::uint64_t input, const MappedPrimeBitmap& bitmap)
+{
+	if(input < bitmap.limit() ? bitmap.isPrime(input) : isPrime(input))
+	{
+		std::cout << "The number is prime.\n";
+		return;
+	}
+
+	std::cout << "The number is not prime.\n";
+
+	const auto factors{ factorize(input) };
+	if(factors.empty())
+	{
+		return;
+	}
+
+	std::cout << input << " = " << factors.front();
+	for(std::size_t i{ 1 }; i < factors.size(); ++i)
+		std::cout << " * " << factors[i];
+	std::cout << '\n';
+}
+
+int runBatch(const char* path, std::size_t threads, const MappedPrimeBitmap& bitmap)
+{
+	std::FILE* in{ path ? std::fopen(path, "rb") : stdin };
+	if(!in)
+	{
+		std::cerr << "Can not open " << path << '\n';
+		return 1;
+	}
+
+	std::unique_ptr<ThreadPool> pool{};
+	if(threads > 1)
+		pool = std::make_unique<ThreadPool>(threads);
+
+	Timer timer{};
+	const BatchStats stats{ classifyStream(in, stdout, pool.get(), bitmap.isOpen() ? &bitmap : nullptr) };
+	const double seconds{ timer.elapsed() };
+
+	if(path)
+		std::fclose(in);
+
+	std::cerr << stats.lines << " numbers, " << stats.primes << " prime, " << stats.invalid << " invalid, "
+		  << seconds << " s (" << (seconds > 0 ? stats.lines / seconds : 0.0) << " numbers/s)\n";
+
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	bool batch{ false };
+	const char* path{ nullptr };
+	const char* bitmapPath{ nullptr };
+	std::size_t threads{ 1 };
+	for(int i{ 1 }; i < argc; ++i)
+	{
+		const std::string arg{ argv[i] };
+		if(arg == "--batch")
+			batch = true;
+		else if(arg == "--threads" && i + 1 < argc)
+			threads = std::stoul(argv[++i]);
+		else if(arg == "--bitmap" && i + 1 < argc)
+			bitmapPath = argv[++i];
+		else
+			path = argv[i];
+	}
+
+	MappedPrimeBitmap bitmap{};
+	if(bitmapPath)
+	{
+		std::string error{};
+		if(!bitmap.open(bitmapPath, error))
+		{
+			std::cerr << error << '\n';
+			return 1;
+		}
+	}
+
+	if(batch)
+	{
+		return runBatch(path, threads, bitmap);
+	}
+
+	std::cout << "JFF\n\n"
+		  << "Sift the Two's and Sift the Three's,\n"
+		  << "The Sieve of Eratosthenes.\n"
+		  << "When the multiples sublime,\n"
+		  << "The numbers that remain are Prime.\n\n\n";
+
+	while(std::cin)
+	{
+		std::uint64_t input{};
+
+		if(getNumber(input))
+		{
+			printAnswer(input, bitmap);
+			return 0;
+		}
+	}
+
+	return 1;
+}
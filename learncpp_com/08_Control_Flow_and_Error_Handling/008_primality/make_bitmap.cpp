@@ -0,0 +1,77 @@
+// Write a prime bitmap file for other processes to map, then reopen it and spot-check it against isPrime().
+// Usage: make_bitmap [--threads N] path [limit]     (default limit: 2^34, a 546 MiB file)
+
+// Build: g++ -std=c++17 -O2 -pthread make_bitmap.cpp bitmap_file.cpp parallel_sieve.cpp primality.cpp sieve.cpp thread_pool.cpp
+
+#include "bitmap_file.h"
+#include "primality.h"
+#include "thread_pool.h"
+#include "timer.h"
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+	std::size_t threads{ std::thread::hardware_concurrency() };
+	std::vector<std::string> arguments{};
+	for(int i{ 1 }; i < argc; ++i)
+	{
+		const std::string arg{ argv[i] };
+		if(arg == "--threads" && i + 1 < argc)
+			threads = std::stoul(argv[++i]);
+		else
+			arguments.push_back(arg);
+	}
+
+	if(arguments.empty() || arguments.size() > 2)
+	{
+		std::cerr << "Usage: make_bitmap [--threads N] path [limit]\n";
+		return 1;
+	}
+
+	const std::string& path{ arguments[0] };
+	const std::uint64_t limit{ arguments.size() == 2 ? std::stoull(arguments[1]) : std::uint64_t{ 1 } << 34 };
+
+	ThreadPool pool{ threads == 0 ? 1 : threads };
+	std::string error{};
+	Timer timer{};
+	if(!writePrimeBitmap(path, limit, pool, error))
+	{
+		std::cerr << error << '\n';
+		return 1;
+	}
+	std::cout << "Wrote " << path << " covering [0, " << limit << ") in " << timer.elapsed() << " s\n";
+
+	timer.reset();
+	MappedPrimeBitmap bitmap{};
+	if(!bitmap.open(path, error))
+	{
+		std::cerr << error << '\n';
+		return 1;
+	}
+	std::cout << "Mapped it again in " << timer.elapsed() * 1e6 << " us\n";
+
+	if(!bitmap.checksumMatches())
+	{
+		std::cerr << "Checksum mismatch\n";
+		return 1;
+	}
+
+	std::mt19937_64 mt{ limit };
+	int mismatches{ 0 };
+	constexpr int samples{ 1'000'000 };
+	for(int i{ 0 }; i < samples; ++i)
+	{
+		const auto index{ static_cast<std::uint64_t>(i) };
+		const std::uint64_t n{ index < 1000 && index < limit ? index : mt() % limit };
+		if(bitmap.isPrime(n) != isPrime(n))
+			++mismatches;
+	}
+	std::cout << "Checksum ok, " << mismatches << " mismatches in " << samples << " lookups against isPrime()\n";
+
+	return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+#include "parallel_sieve.h"
+#include "sieve.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Chunks stay between these sizes (in numbers, not odd numbers). Every chunk recomputes the first
+// multiple of each sieving prime, so chunks must be long enough for that setup to be noise.
+constexpr std::uint64_t minChunkSize{ 1 << 20 };
+constexpr std::uint64_t maxChunkSize{ 1 << 26 };
+constexpr std::uint64_t chunksPerWorker{ 8 };
+
+// Chunks in flight per worker while listing primes; bounds the memory held by unconsumed results
+constexpr std::size_t listWindowPerWorker{ 4 };
+
+std::uint64_t pickChunkSize(std::uint64_t lo, std::uint64_t hi, const ThreadPool& pool, std::uint64_t chunkSize)
+{
+	if(chunkSize != 0)
+	{
+		return chunkSize;
+	}
+
+	const std::uint64_t perChunk{ (hi - lo) / (pool.size() * chunksPerWorker) + 1 };
+
+	return std::clamp(perChunk, minChunkSize, maxChunkSize);
+}
+
+std::uint64_t chunkCount(std::uint64_t lo, std::uint64_t hi, std::uint64_t chunkSize)
+{
+	return (hi - lo) / chunkSize + 1;
+}
+
+std::uint64_t chunkLow(std::uint64_t lo, std::uint64_t chunk, std::uint64_t chunkSize)
+{
+	return lo + chunk * chunkSize;
+}
+
+std::uint64_t chunkHigh(std::uint64_t lo, std::uint64_t hi, std::uint64_t chunk, std::uint64_t chunkSize)
+{
+	return std::min(hi, lo + chunk * chunkSize + (chunkSize - 1));
+}
+
+std::uint64_t parallelCountPrimes(std::uint64_t lo, std::uint64_t hi, ThreadPool& pool, std::uint64_t chunkSize)
+{
+	if(lo > hi)
+	{
+		return 0;
+	}
+
+	chunkSize = pickChunkSize(lo, hi, pool, chunkSize);
+	const std::vector<std::uint32_t> primes{ sievingPrimes(hi) };
+	const std::uint64_t chunks{ chunkCount(lo, hi, chunkSize) };
+
+	// one slot per chunk: workers never share a counter, and the sum below is always taken in chunk order
+	std::vector<std::uint64_t> counts(chunks);
+	for(std::uint64_t chunk{ 0 }; chunk < chunks; ++chunk)
+	{
+		const std::uint64_t low{ chunkLow(lo, chunk, chunkSize) };
+		const std::uint64_t high{ chunkHigh(lo, hi, chunk, chunkSize) };
+		pool.submit([&counts, &primes, chunk, low, high] { counts[chunk] = countPrimes(low, high, primes); },
+			    high - low + 1);
+	}
+	pool.wait();
+
+	std::uint64_t total{ 0 };
+	for(std::uint64_t count : counts)
+		total += count;
+
+	return total;
+}
+
+void parallelForEachPrime(std::uint64_t lo, std::uint64_t hi, ThreadPool& pool,
+			  const std::function<void(const std::vector<std::uint64_t>&)>& consume,
+			  std::uint64_t chunkSize)
+{
+	if(lo > hi)
+	{
+		return;
+	}
+
+	chunkSize = pickChunkSize(lo, hi, pool, chunkSize);
+	const std::vector<std::uint32_t> primes{ sievingPrimes(hi) };
+	const std::uint64_t chunks{ chunkCount(lo, hi, chunkSize) };
+	const std::uint64_t window{ pool.size() * listWindowPerWorker };
+
+	std::vector<std::vector<std::uint64_t>> results(static_cast<std::size_t>(std::min(window, chunks)));
+	for(std::uint64_t first{ 0 }; first < chunks; first += window)
+	{
+		const std::uint64_t last{ std::min(chunks, first + window) };
+		for(std::uint64_t chunk{ first }; chunk < last; ++chunk)
+		{
+			const std::uint64_t low{ chunkLow(lo, chunk, chunkSize) };
+			const std::uint64_t high{ chunkHigh(lo, hi, chunk, chunkSize) };
+			auto& out{ results[static_cast<std::size_t>(chunk - first)] };
+			pool.submit([&out, &primes, low, high]
+			{
+				out.clear();
+				appendPrimesInRange(low, high, primes, out);
+			}, high - low + 1);
+		}
+		pool.wait();
+
+		for(std::uint64_t chunk{ first }; chunk < last; ++chunk)
+			consume(results[static_cast<std::size_t>(chunk - first)]);
+	}
+}
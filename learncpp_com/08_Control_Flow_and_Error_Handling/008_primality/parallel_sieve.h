@@ -0,0 +1,21 @@
+#ifndef PARALLEL_SIEVE_H
+#define PARALLEL_SIEVE_H
+
+#include "thread_pool.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+	// Splits [lo, hi] into chunks of whole sieve segments and sieves them on the pool.
+	// Results do not depend on the number of threads or on which worker ran which chunk.
+
+	// chunkSize 0 picks a size that gives every worker several chunks to balance with
+	std::uint64_t parallelCountPrimes(std::uint64_t lo, std::uint64_t hi, ThreadPool& pool, std::uint64_t chunkSize = 0);
+
+	// Calls consume once per chunk, in ascending order, with that chunk's primes.
+	// Only a bounded window of chunks is held in memory at a time, so the range can be far larger than RAM.
+	void parallelForEachPrime(std::uint64_t lo, std::uint64_t hi, ThreadPool& pool,
+				  const std::function<void(const std::vector<std::uint64_t>&)>& consume,
+				  std::uint64_t chunkSize = 0);
+
+#endif
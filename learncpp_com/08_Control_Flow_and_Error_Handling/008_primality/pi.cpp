@@ -0,0 +1,138 @@
+// Offline prime counting and listing on all cores.
+// Usage: pi [--threads N] [--list] [--scaling] lo hi
+//   default        print pi(hi) - pi(lo - 1), then per-thread throughput on stderr
+//   --list         write every prime in [lo, hi] to stdout, one per line, in ascending order
+//   --scaling      repeat the count with 1, 2, 4, ... threads and report the speedup
+
+// Build: g++ -std=c++17 -O2 -pthread pi.cpp parallel_sieve.cpp sieve.cpp thread_pool.cpp
+
+#include "parallel_sieve.h"
+#include "sieve.h"
+#include "thread_pool.h"
+#include "timer.h"
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+void printThroughput(const ThreadPool& pool, double wallSeconds)
+{
+	std::uint64_t totalNumbers{ 0 };
+	std::cerr << "thread     tasks    stolen    busy (s)    numbers/s\n";
+
+	const auto stats{ pool.stats() };
+	for(std::size_t i{ 0 }; i < stats.size(); ++i)
+	{
+		const auto& worker{ stats[i] };
+		totalNumbers += worker.workUnits;
+		std::cerr << std::setw(6) << i << std::setw(10) << worker.tasks << std::setw(10) << worker.steals
+			  << std::setw(12) << std::fixed << std::setprecision(3) << worker.busySeconds
+			  << std::setw(13) << std::scientific << std::setprecision(3)
+			  << (worker.busySeconds > 0 ? worker.workUnits / worker.busySeconds : 0.0) << '\n';
+	}
+
+	std::cerr << "total: " << totalNumbers << " numbers in " << std::fixed << wallSeconds << " s wall, "
+		  << std::scientific << totalNumbers / wallSeconds << " numbers/s\n" << std::defaultfloat;
+}
+
+void listPrimes(std::uint64_t lo, std::uint64_t hi, ThreadPool& pool)
+{
+	std::string buffer{};
+	buffer.reserve(1 << 20);
+
+	parallelForEachPrime(lo, hi, pool, [&buffer](const std::vector<std::uint64_t>& primes)
+	{
+		char digits[24]{};
+		for(std::uint64_t p : primes)
+		{
+			char* end{ std::to_chars(digits, digits + sizeof(digits), p).ptr };
+			buffer.append(digits, end);
+			buffer.push_back('\n');
+
+			if(buffer.size() > (1 << 20) - 32)
+			{
+				std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+				buffer.clear();
+			}
+		}
+	});
+
+	std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+}
+
+void reportScaling(std::uint64_t lo, std::uint64_t hi, std::size_t maxThreads)
+{
+	std::vector<std::size_t> threadCounts{};
+	for(std::size_t threads{ 1 }; threads < maxThreads; threads *= 2)
+		threadCounts.push_back(threads);
+	threadCounts.push_back(maxThreads);
+
+	double baseline{ 0.0 };
+	std::cout << "threads    count           seconds     speedup\n";
+
+	for(std::size_t threads : threadCounts)
+	{
+		ThreadPool pool{ threads };
+		Timer timer{};
+		const std::uint64_t count{ parallelCountPrimes(lo, hi, pool) };
+		const double seconds{ timer.elapsed() };
+		if(threads == 1)
+			baseline = seconds;
+
+		std::cout << std::setw(7) << threads << std::setw(16) << count
+			  << std::setw(12) << std::fixed << std::setprecision(3) << seconds
+			  << std::setw(12) << std::setprecision(2) << baseline / seconds << '\n';
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::size_t threads{ std::thread::hardware_concurrency() };
+	bool list{ false };
+	bool scaling{ false };
+	std::vector<std::uint64_t> bounds{};
+
+	for(int i{ 1 }; i < argc; ++i)
+	{
+		const std::string arg{ argv[i] };
+		if(arg == "--threads" && i + 1 < argc)
+			threads = std::stoul(argv[++i]);
+		else if(arg == "--list")
+			list = true;
+		else if(arg == "--scaling")
+			scaling = true;
+		else
+			bounds.push_back(std::stoull(arg));
+	}
+
+	if(bounds.size() != 2 || bounds[0] > bounds[1] || bounds[1] >= maxSieveBound)
+	{
+		std::cerr << "Usage: pi [--threads N] [--list] [--scaling] lo hi\n";
+		return 1;
+	}
+
+	if(threads == 0)
+		threads = 1;
+
+	if(scaling)
+	{
+		reportScaling(bounds[0], bounds[1], threads);
+		return 0;
+	}
+
+	ThreadPool pool{ threads };
+	Timer timer{};
+
+	if(list)
+		listPrimes(bounds[0], bounds[1], pool);
+	else
+		std::cout << parallelCountPrimes(bounds[0], bounds[1], pool) << '\n';
+
+	printThroughput(pool, timer.elapsed());
+
+	return 0;
+}
@@ -0,0 +1,83 @@
+#include "primality.h"
+#include "prime_table.h"
+#include "../../05_Operators/002_pow/powmod.h"
+
+#include <array>
+#include <cstdint>
+
+constexpr std::array<std::uint32_t, 16> smallPrimes{ 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53 };
+
+// Witness sets that make Miller-Rabin deterministic below 2^32 (Jaeschke) and below 2^64 (Sinclair)
+constexpr std::array<std::uint64_t, 3> witnesses32{ 2, 7, 61 };
+constexpr std::array<std::uint64_t, 7> witnesses64{ 2, 325, 9375, 28178, 450775, 9780504, 1795265022 };
+
+// One Miller-Rabin round, with n - 1 = d * 2^s and d odd. All arithmetic stays in Montgomery form.
+bool isStrongProbablePrime(const Montgomery64& montgomery, std::uint64_t d, int s, std::uint64_t witness)
+{
+	const std::uint64_t n{ montgomery.modulus() };
+	witness %= n;
+	if(witness == 0)
+		return true;            // a witness divisible by n says nothing
+
+	const std::uint64_t one{ montgomery.one() };
+	const std::uint64_t minusOne{ n - one };        // Montgomery form of n - 1
+
+	std::uint64_t x{ montgomery.power(montgomery.toMontgomery(witness), d) };
+	if(x == one || x == minusOne)
+		return true;
+
+	for(int r{ 1 }; r < s; ++r)
+	{
+		x = montgomery.multiply(x, x);
+		if(x == minusOne)
+			return true;
+	}
+
+	return false;
+}
+
+template <typename Witnesses>
+bool passesAllWitnesses(std::uint64_t n, const Witnesses& witnesses)
+{
+	std::uint64_t d{ n - 1 };
+	int s{ 0 };
+	while(d % 2 == 0)
+	{
+		d /= 2;
+		++s;
+	}
+
+	const Montgomery64 montgomery{ n };
+	for(std::uint64_t witness : witnesses)
+	{
+		if(!isStrongProbablePrime(montgomery, d, s, witness))
+			return false;
+	}
+
+	return true;
+}
+
+bool isPrimeMillerRabin(std::uint64_t n)
+{
+	if(n < (1ULL << 32))
+		return passesAllWitnesses(n, witnesses32);
+
+	return passesAllWitnesses(n, witnesses64);
+}
+
+bool isPrime(std::uint64_t n)
+{
+	if(n < primeTableLimit)
+	{
+		return isPrimeSmall(static_cast<std::uint32_t>(n));
+	}
+
+	// n is far above every small prime here, so any small factor makes it composite
+	for(std::uint32_t p : smallPrimes)
+	{
+		if(n % p == 0)
+			return false;
+	}
+
+	return isPrimeMillerRabin(n);
+}
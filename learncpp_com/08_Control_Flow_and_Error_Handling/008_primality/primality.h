@@ -0,0 +1,13 @@
+#ifndef PRIMALITY_H
+#define PRIMALITY_H
+
+#include <cstdint>
+
+	// Deterministic for every 64-bit input: one bit test in the compile-time table for n < 2^20,
+	// a small-prime filter and Miller-Rabin with a fixed witness set above that
+	bool isPrime(std::uint64_t n);
+
+	// Assumes n is odd and n > 3
+	bool isPrimeMillerRabin(std::uint64_t n);
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef PRIME_TABLE_H
+#define PRIME_TABLE_H
+
+#include <array>
+#include <cstdint>
+
+// Compile-time prime bitmap for every number below primeTableLimit.
+// Mod-30 wheel: of each 30 consecutive numbers only the 8 coprime to 30 can be prime (beyond 2, 3 and 5),
+// so one byte holds 30 numbers and the 2^20 table takes 34 KiB of read-only data.
+// The table is built while compiling; Clang needs a larger -fconstexpr-steps than its default for it.
+
+inline constexpr std::uint32_t primeTableLimit{ 1 << 20 };
+
+inline constexpr std::array<std::uint8_t, 8> wheelResidues{ 1, 7, 11, 13, 17, 19, 23, 29 };
+
+// Bit of each residue mod 30 inside its byte; 0 for residues that share a factor with 30
+inline constexpr std::array<std::uint8_t, 30> wheelBit{
+	0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00,
+	0x00, 0x04, 0x00, 0x08, 0x00, 0x00, 0x00, 0x10, 0x00, 0x20,
+	0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+};
+
+using PrimeTable = std::array<std::uint8_t, primeTableLimit / 30 + 1>;
+
+constexpr PrimeTable makePrimeTable()
+{
+	// raw pointers instead of std::array::operator[] keep the compile-time evaluation cheap
+	PrimeTable table{};
+	std::uint8_t* const bytes{ table.data() };
+	const std::uint8_t* const bit{ wheelBit.data() };
+	const std::uint8_t* const residues{ wheelResidues.data() };
+
+	for(std::uint32_t i{ 0 }; i < table.size(); ++i)
+		bytes[i] = 0xFF;
+
+	bytes[0] &= static_cast<std::uint8_t>(~bit[1]);        // 1 is not prime
+
+	// the last byte runs past the limit; clear those numbers so the table never claims them
+	for(std::uint32_t n{ primeTableLimit }; n < table.size() * 30; ++n)
+		bytes[n / 30] &= static_cast<std::uint8_t>(~bit[n % 30]);
+
+	// Cross off p * k for every prime p >= 7 and every k >= p on the wheel; other multiples are off the wheel.
+	// Within one residue class of k the multiples are 30 * p apart, so they sit in the same bit of every p-th byte.
+	for(std::uint32_t q{ 0 }; q < table.size(); ++q)
+	{
+		for(std::uint32_t j{ 0 }; j < 8; ++j)
+		{
+			const std::uint32_t p{ 30 * q + residues[j] };
+			if(p < 7 || !(bytes[q] & bit[residues[j]]))
+				continue;
+			if(p * p >= primeTableLimit)
+				return table;
+
+			for(std::uint32_t r{ 0 }; r < 8; ++r)
+			{
+				const std::uint32_t k{ 30 * q + residues[r] + (r < j ? 30 : 0) };
+				const std::uint32_t m{ p * k };
+				const auto mask{ static_cast<std::uint8_t>(~bit[m % 30]) };
+
+				for(std::uint32_t i{ m / 30 }; i < table.size(); i += p)
+					bytes[i] &= mask;
+			}
+		}
+	}
+
+	return table;
+}
+
+inline constexpr PrimeTable primeTable{ makePrimeTable() };
+
+// n must be below primeTableLimit
+constexpr bool isPrimeSmall(std::uint32_t n)
+{
+	if(n < 30)
+		return n == 2 || n == 3 || n == 5 || (primeTable[0] & wheelBit[n]);
+
+	return primeTable[n / 30] & wheelBit[n % 30];
+}
+
+static_assert(!isPrimeSmall(0) && !isPrimeSmall(1) && isPrimeSmall(2) && isPrimeSmall(29) && !isPrimeSmall(49));
+static_assert(isPrimeSmall(1'048'573) && !isPrimeSmall(1'048'575));     // the largest prime below 2^20
+
+#endif
@@ -0,0 +1,148 @@
+#include "sieve.h"
+#include "../010_isqrt/isqrt.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+// Odd numbers covered by one segment. With one byte per odd number a segment fits in the L1 cache.
+constexpr std::size_t segmentSize{ 32 * 1024 };
+
+std::vector<std::uint32_t> sievingPrimes(std::uint64_t hi)
+{
+	assert(hi < maxSieveBound && "Sieve bound too large");
+
+	const std::uint64_t limit{ isqrt(hi) };
+	std::vector<std::uint32_t> primes{};
+	if(limit < 3)
+	{
+		return primes;
+	}
+
+	// index i stands for the odd number 2 * i + 1
+	std::vector<unsigned char> isPrime(limit / 2 + 1, 1);
+	for(std::uint64_t i{ 1 }; (2 * i + 1) * (2 * i + 1) <= limit; ++i)
+	{
+		if(!isPrime[i])
+			continue;
+
+		const std::uint64_t p{ 2 * i + 1 };
+		for(std::uint64_t j{ (p * p) / 2 }; j < isPrime.size(); j += p)
+			isPrime[j] = 0;
+	}
+
+	for(std::uint64_t i{ 1 }; 2 * i + 1 <= limit; ++i)
+	{
+		if(isPrime[i])
+			primes.push_back(static_cast<std::uint32_t>(2 * i + 1));
+	}
+
+	return primes;
+}
+
+// Sieves the odd numbers of [lo, hi] one segment at a time.
+// For every segment calls visit(firstOdd, flags, size), where flags[i] is 1 if firstOdd + 2 * i is prime.
+template <typename Visitor>
+void sieveOddNumbers(std::uint64_t lo, std::uint64_t hi, const std::vector<std::uint32_t>& primes, Visitor visit)
+{
+	assert(hi < maxSieveBound && "Sieve bound too large");
+
+	const std::uint64_t first{ lo | 1 };    // first odd number >= lo
+	if(first > hi)
+	{
+		return;
+	}
+
+	const std::uint64_t oddCount{ (hi - first) / 2 + 1 };
+
+	// index (counted in odd numbers from first) of the next odd multiple of each prime still to cross off
+	std::vector<std::uint64_t> next(primes.size());
+	for(std::size_t j{ 0 }; j < primes.size(); ++j)
+	{
+		const std::uint64_t p{ primes[j] };
+		std::uint64_t start{ std::max(p * p, (first + p - 1) / p * p) };
+		if(start % 2 == 0)
+			start += p;
+
+		next[j] = (start - first) / 2;
+	}
+
+	std::vector<unsigned char> segment(segmentSize);
+	for(std::uint64_t done{ 0 }; done < oddCount; done += segmentSize)
+	{
+		const auto size{ static_cast<std::size_t>(std::min<std::uint64_t>(segmentSize, oddCount - done)) };
+		const std::uint64_t segmentHigh{ first + 2 * (done + size - 1) };
+		std::fill_n(segment.begin(), size, 1);
+
+		for(std::size_t j{ 0 }; j < primes.size(); ++j)
+		{
+			const std::uint64_t p{ primes[j] };
+			if(p * p > segmentHigh)
+				break;          // primes are sorted, so no later prime has a multiple to cross here
+
+			std::uint64_t i{ next[j] - done };
+			for(; i < size; i += p)
+				segment[i] = 0;
+
+			next[j] = done + i;
+		}
+
+		if(first == 1 && done == 0)
+			segment[0] = 0;     // 1 is not prime
+
+		visit(first + 2 * done, segment.data(), size);
+	}
+}
+
+std::uint64_t countPrimes(std::uint64_t lo, std::uint64_t hi, const std::vector<std::uint32_t>& primes)
+{
+	if(lo > hi)
+	{
+		return 0;
+	}
+
+	std::uint64_t count{ (lo <= 2 && hi >= 2) ? 1u : 0u };
+	sieveOddNumbers(lo, hi, primes, [&count](std::uint64_t, const unsigned char* flags, std::size_t size)
+	{
+		count += std::accumulate(flags, flags + size, std::uint64_t{ 0 });
+	});
+
+	return count;
+}
+
+std::uint64_t countPrimes(std::uint64_t lo, std::uint64_t hi)
+{
+	return countPrimes(lo, hi, sievingPrimes(hi));
+}
+
+void appendPrimesInRange(std::uint64_t lo, std::uint64_t hi, const std::vector<std::uint32_t>& primes,
+			 std::vector<std::uint64_t>& out)
+{
+	if(lo > hi)
+	{
+		return;
+	}
+
+	if(lo <= 2 && hi >= 2)
+		out.push_back(2);
+
+	sieveOddNumbers(lo, hi, primes, [&out](std::uint64_t firstOdd, const unsigned char* flags, std::size_t size)
+	{
+		for(std::size_t i{ 0 }; i < size; ++i)
+		{
+			if(flags[i])
+				out.push_back(firstOdd + 2 * i);
+		}
+	});
+}
+
+std::vector<std::uint64_t> primesInRange(std::uint64_t lo, std::uint64_t hi)
+{
+	std::vector<std::uint64_t> primes{};
+	appendPrimesInRange(lo, hi, sievingPrimes(hi), primes);
+
+	return primes;
+}
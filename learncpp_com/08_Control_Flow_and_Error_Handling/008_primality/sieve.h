@@ -0,0 +1,21 @@
+#ifndef SIEVE_H
+#define SIEVE_H
+
+#include <cstdint>
+#include <vector>
+
+	// Segmented Sieve of Eratosthenes over odd numbers only.
+	// Ranges are inclusive and must stay below maxSieveBound.
+	inline constexpr std::uint64_t maxSieveBound{ 1ULL << 62 };
+
+	// Odd primes up to sqrt(hi), needed to sieve any range ending at hi
+	std::vector<std::uint32_t> sievingPrimes(std::uint64_t hi);
+
+	std::uint64_t countPrimes(std::uint64_t lo, std::uint64_t hi);
+	std::uint64_t countPrimes(std::uint64_t lo, std::uint64_t hi, const std::vector<std::uint32_t>& primes);
+
+	std::vector<std::uint64_t> primesInRange(std::uint64_t lo, std::uint64_t hi);
+	void appendPrimesInRange(std::uint64_t lo, std::uint64_t hi, const std::vector<std::uint32_t>& primes,
+				 std::vector<std::uint64_t>& out);
+
+#endif
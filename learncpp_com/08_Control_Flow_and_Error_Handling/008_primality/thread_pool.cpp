@@ -0,0 +1,155 @@
+#include "thread_pool.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Identifies the worker running on this thread, so tasks submitted from inside a task stay local
+thread_local const ThreadPool* t_pool{ nullptr };
+thread_local std::size_t t_workerIndex{ 0 };
+
+ThreadPool::ThreadPool(std::size_t threadCount)
+{
+	if(threadCount == 0)
+		threadCount = 1;
+
+	for(std::size_t i{ 0 }; i < threadCount; ++i)
+		m_workers.push_back(std::make_unique<Worker>());
+
+	for(std::size_t i{ 0 }; i < threadCount; ++i)
+		m_threads.emplace_back(&ThreadPool::run, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard lock{ m_stateMutex };
+		m_stopping = true;
+	}
+	m_workAvailable.notify_all();
+
+	for(auto& thread : m_threads)
+		thread.join();
+}
+
+void ThreadPool::submit(std::function<void()> task, std::uint64_t units)
+{
+	const std::size_t target{ t_pool == this ? t_workerIndex : m_nextWorker++ % m_workers.size() };
+
+	++m_pending;
+	{
+		// counted before it is pushed, so a worker can never take it while m_queued still reads zero
+		std::lock_guard lock{ m_stateMutex };
+		++m_queued;
+	}
+
+	{
+		Worker& worker{ *m_workers[target] };
+		std::lock_guard lock{ worker.mutex };
+		worker.tasks.push_back(std::move(task));
+		worker.units.push_back(units);
+	}
+	m_workAvailable.notify_one();
+}
+
+bool ThreadPool::tryTake(std::size_t index, std::function<void()>& task, std::uint64_t& units, bool& stolen)
+{
+	// own deque first, newest task first: it is the one most likely to still be in cache
+	{
+		Worker& own{ *m_workers[index] };
+		std::lock_guard lock{ own.mutex };
+		if(!own.tasks.empty())
+		{
+			task = std::move(own.tasks.back());
+			units = own.units.back();
+			own.tasks.pop_back();
+			own.units.pop_back();
+			stolen = false;
+			return true;
+		}
+	}
+
+	// then steal the oldest task of the next workers in turn
+	for(std::size_t offset{ 1 }; offset < m_workers.size(); ++offset)
+	{
+		Worker& victim{ *m_workers[(index + offset) % m_workers.size()] };
+		std::lock_guard lock{ victim.mutex };
+		if(!victim.tasks.empty())
+		{
+			task = std::move(victim.tasks.front());
+			units = victim.units.front();
+			victim.tasks.pop_front();
+			victim.units.pop_front();
+			stolen = true;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ThreadPool::run(std::size_t index)
+{
+	t_pool = this;
+	t_workerIndex = index;
+	WorkerStats& stats{ m_workers[index]->stats };
+
+	while(true)
+	{
+		std::function<void()> task{};
+		std::uint64_t units{};
+		bool stolen{};
+
+		if(tryTake(index, task, units, stolen))
+		{
+			--m_queued;
+
+			const auto start{ std::chrono::steady_clock::now() };
+			task();
+			const std::chrono::duration<double> busy{ std::chrono::steady_clock::now() - start };
+
+			++stats.tasks;
+			stats.steals += stolen ? 1 : 0;
+			stats.workUnits += units;
+			stats.busySeconds += busy.count();
+
+			if(--m_pending == 0)
+			{
+				std::lock_guard lock{ m_stateMutex };
+				m_allDone.notify_all();
+			}
+
+			continue;
+		}
+
+		std::unique_lock lock{ m_stateMutex };
+		m_workAvailable.wait(lock, [this] { return m_stopping || m_queued > 0; });
+		if(m_stopping && m_queued == 0)
+			return;
+	}
+}
+
+void ThreadPool::wait()
+{
+	std::unique_lock lock{ m_stateMutex };
+	m_allDone.wait(lock, [this] { return m_pending == 0; });
+}
+
+std::vector<ThreadPool::WorkerStats> ThreadPool::stats() const
+{
+	std::vector<WorkerStats> result{};
+	for(const auto& worker : m_workers)
+		result.push_back(worker->stats);
+
+	return result;
+}
+
+void ThreadPool::resetStats()
+{
+	for(auto& worker : m_workers)
+		worker->stats = WorkerStats{};
+}
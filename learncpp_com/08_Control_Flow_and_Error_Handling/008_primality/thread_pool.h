@@ -0,0 +1,72 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size work-stealing thread pool.
+// Every worker owns a deque: it takes its own tasks from the back and, when it runs dry,
+// steals from the front of the other workers' deques.
+class ThreadPool
+{
+public:
+	struct WorkerStats
+	{
+		std::uint64_t tasks{};          // tasks run by this worker
+		std::uint64_t steals{};         // of those, tasks taken from another worker's deque
+		std::uint64_t workUnits{};      // sum of the units passed to submit()
+		double busySeconds{};
+	};
+
+private:
+	struct Worker
+	{
+		std::mutex mutex{};
+		std::deque<std::function<void()>> tasks{};
+		std::deque<std::uint64_t> units{};
+		WorkerStats stats{};
+	};
+
+	std::vector<std::unique_ptr<Worker>> m_workers{};
+	std::vector<std::thread> m_threads{};
+
+	std::mutex m_stateMutex{};
+	std::condition_variable m_workAvailable{};
+	std::condition_variable m_allDone{};
+	std::atomic<std::size_t> m_queued{ 0 };        // tasks sitting in some deque
+	std::atomic<std::size_t> m_pending{ 0 };       // tasks submitted and not finished
+	std::atomic<std::size_t> m_nextWorker{ 0 };    // round robin target for tasks submitted from outside
+	bool m_stopping{ false };
+
+	void run(std::size_t index);
+	bool tryTake(std::size_t index, std::function<void()>& task, std::uint64_t& units, bool& stolen);
+
+public:
+	explicit ThreadPool(std::size_t threadCount = std::thread::hardware_concurrency());
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// units is only bookkeeping: it is added to the stats of whichever worker runs the task
+	void submit(std::function<void()> task, std::uint64_t units = 1);
+
+	// Blocks until every task submitted so far has finished
+	void wait();
+
+	std::size_t size() const { return m_workers.size(); }
+
+	// Only meaningful after wait()
+	std::vector<WorkerStats> stats() const;
+	void resetStats();
+};
+
+#endif
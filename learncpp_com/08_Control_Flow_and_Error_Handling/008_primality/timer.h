@@ -0,0 +1,26 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <chrono>
+
+class Timer
+{
+private:
+	using Clock = std::chrono::steady_clock;
+	using Second = std::chrono::duration<double, std::ratio<1>>;
+
+	std::chrono::time_point<Clock> m_beg{ Clock::now() };
+
+public:
+	void reset()
+	{
+		m_beg = Clock::now();
+	}
+
+	double elapsed() const
+	{
+		return std::chrono::duration_cast<Second>(Clock::now() - m_beg).count();
+	}
+};
+
+#endif
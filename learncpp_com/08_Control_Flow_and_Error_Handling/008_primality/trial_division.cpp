@@ -0,0 +1,30 @@
+#include "trial_division.h"
+#include "../010_isqrt/isqrt.h"
+#include <cstdint>
+
+// Calculate the square root of the number
+int sqrtFloor(int input)
+{
+	return static_cast<int>(isqrt(static_cast<std::uint32_t>(input)));
+}
+
+// Check whether the number is prime by dividing it by every candidate up to its square root
+bool isPrimeTrialDivision(int input)
+{
+	if(input == 1 || input ==  0)
+	{
+		return false;
+	}
+
+	const int root{ sqrtFloor(input) };
+	int i{ 2 };
+	while(i <= root)
+	{
+		if(input % i == 0)
+			return false;
+
+		++i;
+	}
+
+	return true;
+}
@@ -0,0 +1,7 @@
+#ifndef TRIAL_DIVISION_H
+#define TRIAL_DIVISION_H
+
+	int sqrtFloor(int input);
+	bool isPrimeTrialDivision(int input);
+
+#endif
@@ -1,26 +1,12 @@
+// Build: g++ -std=c++17 -O2 009_sqrt.cpp
+
+#include "010_isqrt/isqrt.h"
+#include <cstdint>
 #include <iostream>
 
 int sqrtFloor(int input)
 {
-	if(input == 0 || input == 1)
-	{
-		return input;
-	}
-
-	int i{ 1 };
-	int result{ 1 };
-	while(result < input)
-	{
-		++i;
-		result = i * i;
-	}
-
-	if(i * i != input)
-	{
-		return i - 1;
-	}
-
-	return i;
+	return static_cast<int>(isqrt(static_cast<std::uint32_t>(input)));
 }
 
 int getInt()
@@ -0,0 +1,188 @@
+// Check isqrt and every isqrtBatch kernel the CPU supports against exact references,
+// and compare them with the linear sqrtFloor() loop from 009_sqrt.cpp.
+
+// Build: g++ -std=c++17 -O2 benchmark.cpp isqrt.cpp
+
+#include "isqrt.h"
+#include "../008_primality/timer.h"
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// The loop being replaced, kept as the baseline
+int sqrtFloorLinear(int input)
+{
+	if(input == 0 || input == 1)
+	{
+		return input;
+	}
+
+	int i{ 1 };
+	int result{ 1 };
+	while(result < input)
+	{
+		++i;
+		result = i * i;
+	}
+
+	if(i * i != input)
+	{
+		return i - 1;
+	}
+
+	return i;
+}
+
+template <typename UInt>
+bool isFloorRoot(UInt n, UInt root)
+{
+	using Wide = unsigned __int128;
+
+	if constexpr (sizeof(UInt) < sizeof(Wide))
+		return Wide{ root } * root <= n && (Wide{ root } + 1) * (Wide{ root } + 1) > n;
+	else
+		return root * root <= n && root + 1 > n / (root + 1);     // (root + 1)^2 itself can overflow
+}
+
+constexpr IsqrtKernel allKernels[]{ IsqrtKernel::scalar, IsqrtKernel::sse2, IsqrtKernel::avx2 };
+
+bool isSupported(IsqrtKernel kernel)
+{
+	return static_cast<int>(kernel) <= static_cast<int>(bestIsqrtKernel());
+}
+
+int checkCorrectness()
+{
+	std::mt19937_64 mt{ 2024 };
+	int failures{ 0 };
+
+	std::vector<std::uint64_t> inputs64{ 0, 1, 2, 3, 4, 0xFFFF'FFFF'FFFF'FFFF, 0xFFFF'FFFE'0000'0001, 0xFFFF'FFFE'0000'0000 };
+	for(std::uint64_t root{ 1 }; root < (1ULL << 32); root = root * 3 + 1)
+	{
+		for(std::uint64_t delta : { 0ULL, 1ULL })
+		{
+			inputs64.push_back(root * root - delta);
+			inputs64.push_back(root * root + delta);
+		}
+	}
+	for(int i{ 0 }; i < 1'000'000; ++i)
+	{
+		inputs64.push_back(mt() >> (mt() % 64));
+	}
+
+	for(std::uint64_t n : inputs64)
+	{
+		if(!isFloorRoot(n, isqrt(n)))
+			++failures;
+	}
+
+	std::vector<std::uint32_t> inputs32{};
+	for(std::uint64_t n : inputs64)
+		inputs32.push_back(static_cast<std::uint32_t>(n));
+	for(std::uint32_t n : inputs32)
+	{
+		if(!isFloorRoot(n, isqrt(n)))
+			++failures;
+	}
+
+	// each kernel against the scalar isqrt, over counts that leave every possible tail for its scalar loop
+	std::vector<std::uint64_t> roots64(inputs64.size());
+	std::vector<std::uint32_t> roots32(inputs32.size());
+	for(IsqrtKernel kernel : allKernels)
+	{
+		if(!isSupported(kernel))
+			continue;
+
+		for(std::size_t tail{ 0 }; tail < 8; ++tail)
+		{
+			const std::size_t count64{ inputs64.size() - tail };
+			isqrtBatch(inputs64.data(), roots64.data(), count64, kernel);
+			for(std::size_t i{ 0 }; i < count64; ++i)
+			{
+				if(roots64[i] != isqrt(inputs64[i]))
+					++failures;
+			}
+
+			const std::size_t count32{ inputs32.size() - tail };
+			isqrtBatch(inputs32.data(), roots32.data(), count32, kernel);
+			for(std::size_t i{ 0 }; i < count32; ++i)
+			{
+				if(roots32[i] != isqrt(inputs32[i]))
+					++failures;
+			}
+		}
+	}
+
+	for(int i{ 0 }; i < 100'000; ++i)
+	{
+		const unsigned __int128 n{ (static_cast<unsigned __int128>(mt()) << 64 | mt()) >> (mt() % 128) };
+		if(!isFloorRoot(n, isqrt(n)))
+			++failures;
+	}
+	const unsigned __int128 maxValue{ ~static_cast<unsigned __int128>(0) };
+	if(!isFloorRoot(maxValue, isqrt(maxValue)))
+		++failures;
+
+	return failures;
+}
+
+int main()
+{
+	std::cout << "Correctness failures: " << checkCorrectness() << '\n';
+
+	constexpr std::size_t count{ 1 << 20 };
+	std::mt19937 mt{ 7 };
+	std::vector<std::uint32_t> inputs(count);
+	for(auto& n : inputs)
+		n = mt() >> 1;          // sqrtFloorLinear only takes non-negative ints
+
+	// the linear loop is O(sqrt(n)) per call, so it only gets a small sample
+	constexpr std::size_t linearCount{ 2'000 };
+	Timer timer{};
+	std::uint64_t checksum{ 0 };
+	for(std::size_t i{ 0 }; i < linearCount; ++i)
+		checksum += static_cast<std::uint64_t>(sqrtFloorLinear(static_cast<int>(inputs[i])));
+	const double linearNs{ timer.elapsed() * 1e9 / linearCount };
+
+	timer.reset();
+	std::uint64_t scalarChecksum{ 0 };
+	for(std::size_t i{ 0 }; i < count; ++i)
+		scalarChecksum += isqrt(inputs[i]);
+	const double scalarNs{ timer.elapsed() * 1e9 / count };
+
+	std::vector<std::uint64_t> inputs64(count);
+	for(auto& n : inputs64)
+		n = static_cast<std::uint64_t>(mt()) << 32 | mt();
+	std::vector<std::uint64_t> roots64(count);
+
+	timer.reset();
+	for(std::size_t i{ 0 }; i < count; ++i)
+		roots64[i] = isqrt(inputs64[i]);
+	const double scalar64Ns{ timer.elapsed() * 1e9 / count };
+
+	std::cout << "(checksums " << checksum << ' ' << scalarChecksum << ")\n"
+		  << "31-bit inputs, ns per root: linear loop " << linearNs << ", isqrt " << scalarNs << '\n'
+		  << "64-bit inputs, ns per root: isqrt " << scalar64Ns << '\n';
+
+	std::vector<std::uint32_t> roots(count);
+	for(IsqrtKernel kernel : allKernels)
+	{
+		if(!isSupported(kernel))
+			continue;
+
+		timer.reset();
+		isqrtBatch(inputs.data(), roots.data(), count, kernel);
+		const double batchNs{ timer.elapsed() * 1e9 / count };
+
+		timer.reset();
+		isqrtBatch(inputs64.data(), roots64.data(), count, kernel);
+		const double batch64Ns{ timer.elapsed() * 1e9 / count };
+
+		std::cout << "isqrtBatch " << kernelName(kernel) << ", ns per root: 31-bit " << batchNs << ", 64-bit " << batch64Ns
+			  << (kernel == IsqrtKernel::sse2 ? " (scalar loop)" : "") << '\n';
+	}
+
+	return 0;
+}
@@ -0,0 +1,166 @@
+#include "isqrt.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ISQRT_X86 1
+#endif
+
+void isqrtScalar(const std::uint32_t* in, std::uint32_t* out, std::size_t count)
+{
+	for(std::size_t i{ 0 }; i < count; ++i)
+		out[i] = isqrt(in[i]);
+}
+
+void isqrtScalar(const std::uint64_t* in, std::uint64_t* out, std::size_t count)
+{
+	for(std::size_t i{ 0 }; i < count; ++i)
+		out[i] = isqrt(in[i]);
+}
+
+#ifdef ISQRT_X86
+
+// The 32-bit kernels rely on the same argument as the scalar isqrt(std::uint32_t):
+// the double root of a 32-bit number truncates to the exact floor.
+// Unsigned inputs are converted by flipping the sign bit, converting as signed and adding 2^31 back.
+
+__attribute__((target("sse2")))
+void isqrtSse2(const std::uint32_t* in, std::uint32_t* out, std::size_t count)
+{
+	const __m128i signBit{ _mm_set1_epi32(static_cast<int>(0x8000'0000u)) };
+	const __m128d twoTo31{ _mm_set1_pd(2147483648.0) };
+
+	std::size_t i{ 0 };
+	for(; i + 4 <= count; i += 4)
+	{
+		const __m128i n{ _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), signBit) };
+
+		const __m128d low{ _mm_sqrt_pd(_mm_add_pd(_mm_cvtepi32_pd(n), twoTo31)) };
+		const __m128d high{ _mm_sqrt_pd(_mm_add_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(n, 0x4E)), twoTo31)) };
+
+		// roots are below 2^16, so the signed truncating conversion is safe
+		const __m128i root{ _mm_unpacklo_epi64(_mm_cvttpd_epi32(low), _mm_cvttpd_epi32(high)) };
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), root);
+	}
+
+	isqrtScalar(in + i, out + i, count - i);
+}
+
+__attribute__((target("avx2")))
+void isqrtAvx2(const std::uint32_t* in, std::uint32_t* out, std::size_t count)
+{
+	const __m256i signBit{ _mm256_set1_epi32(static_cast<int>(0x8000'0000u)) };
+	const __m256d twoTo31{ _mm256_set1_pd(2147483648.0) };
+
+	std::size_t i{ 0 };
+	for(; i + 8 <= count; i += 8)
+	{
+		const __m256i n{ _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)), signBit) };
+
+		const __m256d low{ _mm256_sqrt_pd(_mm256_add_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(n)), twoTo31)) };
+		const __m256d high{ _mm256_sqrt_pd(_mm256_add_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(n, 1)), twoTo31)) };
+
+		const __m256i root{ _mm256_set_m128i(_mm256_cvttpd_epi32(high), _mm256_cvttpd_epi32(low)) };
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), root);
+	}
+
+	isqrtScalar(in + i, out + i, count - i);
+}
+
+// 64-bit lanes: AVX2 has no unsigned 64-bit to double conversion, so each half is placed in the mantissa
+// of a magic double (2^52 for the low half, 2^84 for the high half) and the two are added with one rounding.
+// The root is then corrected by one in either direction exactly like the scalar isqrt(std::uint64_t),
+// using 32x32->64 multiplies (the root always fits in 32 bits).
+__attribute__((target("avx2")))
+void isqrtAvx2(const std::uint64_t* in, std::uint64_t* out, std::size_t count)
+{
+	const __m256i magicLow{ _mm256_set1_epi64x(0x4330'0000'0000'0000) };        // 2^52
+	const __m256i magicHigh{ _mm256_set1_epi64x(0x4530'0000'0000'0000) };       // 2^84
+	const __m256d magicBoth{ _mm256_set1_pd(19342813118337666422669312.0) };    // 2^84 + 2^52
+	const __m256d twoTo52{ _mm256_set1_pd(4503599627370496.0) };
+	const __m256d maxRoot{ _mm256_set1_pd(4294967295.0) };
+	const __m256i maxRootInt{ _mm256_set1_epi64x(0xFFFF'FFFF) };
+	const __m256i signBit{ _mm256_set1_epi64x(static_cast<long long>(0x8000'0000'0000'0000ull)) };
+	const __m256i one{ _mm256_set1_epi64x(1) };
+
+	std::size_t i{ 0 };
+	for(; i + 4 <= count; i += 4)
+	{
+		const __m256i n{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)) };
+
+		const __m256d low{ _mm256_castsi256_pd(_mm256_blend_epi32(magicLow, n, 0x55)) };
+		const __m256d high{ _mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(n, 32), magicHigh)) };
+		const __m256d value{ _mm256_add_pd(_mm256_sub_pd(high, magicBoth), low) };
+
+		__m256d rootDouble{ _mm256_floor_pd(_mm256_min_pd(_mm256_sqrt_pd(value), maxRoot)) };
+		__m256i root{ _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(rootDouble, twoTo52)),
+					      _mm256_castpd_si256(twoTo52)) };
+
+		// unsigned 64-bit compares, done as signed compares with the sign bits flipped
+		const __m256i nFlipped{ _mm256_xor_si256(n, signBit) };
+
+		const __m256i square{ _mm256_mul_epu32(root, root) };
+		const __m256i tooBig{ _mm256_cmpgt_epi64(_mm256_xor_si256(square, signBit), nFlipped) };
+		root = _mm256_add_epi64(root, tooBig);                                  // -1 where root * root > n
+
+		const __m256i next{ _mm256_add_epi64(root, one) };
+		const __m256i nextSquare{ _mm256_mul_epu32(next, next) };
+		const __m256i nextTooBig{ _mm256_cmpgt_epi64(_mm256_xor_si256(nextSquare, signBit), nFlipped) };
+		const __m256i canGrow{ _mm256_cmpgt_epi64(maxRootInt, root) };
+		root = _mm256_sub_epi64(root, _mm256_andnot_si256(nextTooBig, canGrow)); // +1 where (root + 1)^2 <= n
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), root);
+	}
+
+	isqrtScalar(in + i, out + i, count - i);
+}
+
+#endif
+
+IsqrtKernel bestIsqrtKernel()
+{
+#ifdef ISQRT_X86
+	static const IsqrtKernel best{ __builtin_cpu_supports("avx2")   ? IsqrtKernel::avx2
+				       : __builtin_cpu_supports("sse2") ? IsqrtKernel::sse2
+									: IsqrtKernel::scalar };
+	return best;
+#else
+	return IsqrtKernel::scalar;
+#endif
+}
+
+const char* kernelName(IsqrtKernel kernel)
+{
+	switch(kernel)
+	{
+		case IsqrtKernel::scalar:   return "scalar";
+		case IsqrtKernel::sse2:     return "sse2";
+		case IsqrtKernel::avx2:     return "avx2";
+	}
+
+	return "???";
+}
+
+void isqrtBatch(const std::uint32_t* in, std::uint32_t* out, std::size_t count, IsqrtKernel kernel)
+{
+#ifdef ISQRT_X86
+	if(kernel == IsqrtKernel::avx2)
+		return isqrtAvx2(in, out, count);
+	if(kernel == IsqrtKernel::sse2)
+		return isqrtSse2(in, out, count);
+#endif
+
+	isqrtScalar(in, out, count);
+}
+
+void isqrtBatch(const std::uint64_t* in, std::uint64_t* out, std::size_t count, IsqrtKernel kernel)
+{
+#ifdef ISQRT_X86
+	if(kernel == IsqrtKernel::avx2)
+		return isqrtAvx2(in, out, count);
+#endif
+
+	isqrtScalar(in, out, count);
+}
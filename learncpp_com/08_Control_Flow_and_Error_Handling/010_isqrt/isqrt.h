@@ -0,0 +1,76 @@
+#ifndef ISQRT_H
+#define ISQRT_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Floor of the square root for unsigned 32-, 64- and 128-bit integers, exact for every input.
+// unsigned __int128 is a GCC/Clang extension.
+
+inline std::uint32_t isqrt(std::uint32_t n)
+{
+	// n converts to double exactly and sqrt is correctly rounded. Below 2^32 the distance from
+	// sqrt(n) to the next integer is at least 2^-17, far above the rounding error, so truncating is exact.
+	return static_cast<std::uint32_t>(std::sqrt(static_cast<double>(n)));
+}
+
+inline std::uint64_t isqrt(std::uint64_t n)
+{
+	// Converting n to double and taking the root each add at most half an ulp of error,
+	// so the estimate is within one of the true root and a single correction each way is enough.
+	auto root{ static_cast<std::uint64_t>(std::sqrt(static_cast<double>(n))) };
+	if(root > 0xFFFF'FFFF)
+		root = 0xFFFF'FFFF;         // the largest root of a 64-bit number; the double can round up to 2^32
+
+	if(root * root > n)
+		--root;
+	else if(root < 0xFFFF'FFFF && (root + 1) * (root + 1) <= n)
+		++root;
+
+	return root;
+}
+
+inline unsigned __int128 isqrt(unsigned __int128 n)
+{
+	if(n >> 64 == 0)
+	{
+		return isqrt(static_cast<std::uint64_t>(n));
+	}
+
+	// Take the root of the top 64 bits (shifted by an even amount), then run Newton's iteration
+	// starting from just above the true root. From above, Newton decreases monotonically to the floor.
+	int shift{ 0 };
+	while(n >> shift >> 64 != 0)
+		shift += 2;
+
+	const unsigned __int128 estimate{ static_cast<unsigned __int128>(isqrt(static_cast<std::uint64_t>(n >> shift))) };
+	unsigned __int128 x{ (estimate + 1) << (shift / 2) };
+	unsigned __int128 y{ (x + n / x) / 2 };
+	while(y < x)
+	{
+		x = y;
+		y = (x + n / x) / 2;
+	}
+
+	return x;
+}
+
+// Kernels for isqrtBatch; SSE2 and AVX2 are x86 only, and SSE2 has a 32-bit kernel only (64-bit input runs the
+// scalar loop). bestIsqrtKernel() is the fastest one the CPU supports; passing a kernel the CPU does not support is undefined.
+enum class IsqrtKernel
+{
+	scalar,
+	sse2,
+	avx2,
+};
+
+IsqrtKernel bestIsqrtKernel();
+const char* kernelName(IsqrtKernel kernel);
+
+// Floor square roots of a whole array, the same as the scalar functions above with every kernel.
+// in and out may be the same array.
+void isqrtBatch(const std::uint32_t* in, std::uint32_t* out, std::size_t count, IsqrtKernel kernel = bestIsqrtKernel());
+void isqrtBatch(const std::uint64_t* in, std::uint64_t* out, std::size_t count, IsqrtKernel kernel = bestIsqrtKernel());
+
+#endif
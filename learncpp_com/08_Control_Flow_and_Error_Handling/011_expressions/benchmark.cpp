@@ -0,0 +1,79 @@
+// Compile once and evaluate over many bindings, against recompiling for every binding
+// and against the same expression written directly in C++.
+
+// Build: g++ -std=c++17 -O2 benchmark.cpp expression.cpp
+
+#include "expression.h"
+#include "../008_primality/timer.h"
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+constexpr const char* source{ "(a + b) * (c - d) / (e % 97 + 98) - -a * 3 + (2 * 8 - 1)" };
+
+std::int64_t native(const std::int64_t* v)
+{
+	return (v[0] + v[1]) * (v[2] - v[3]) / (v[4] % 97 + 98) - -v[0] * 3 + (2 * 8 - 1);
+}
+
+int main()
+{
+	constexpr std::size_t bindings{ 5'000'000 };
+	constexpr std::size_t variableCount{ 5 };
+
+	std::mt19937_64 mt{ 2024 };
+	std::uniform_int_distribution<std::int64_t> dist{ -1'000'000, 1'000'000 };
+	std::vector<std::int64_t> values(bindings * variableCount);
+	for(auto& value : values)
+		value = dist(mt);
+
+	Program program{};
+	std::string error{};
+	if(!compile(source, program, error) || program.variables.size() != variableCount)
+	{
+		std::cout << error << '\n';
+		return 1;
+	}
+
+	std::cout << source << '\n' << program.code.size() << " instructions, stack depth " << program.maxStack << "\n\n";
+
+	Timer timer{};
+	std::int64_t nativeSum{ 0 };
+	for(std::size_t i{ 0 }; i < bindings; ++i)
+		nativeSum += native(&values[i * variableCount]);
+	const double nativeSeconds{ timer.elapsed() };
+
+	timer.reset();
+	std::int64_t bytecodeSum{ 0 };
+	for(std::size_t i{ 0 }; i < bindings; ++i)
+	{
+		std::int64_t result{};
+		evaluate(program, &values[i * variableCount], result);
+		bytecodeSum += result;
+	}
+	const double bytecodeSeconds{ timer.elapsed() };
+
+	// recompiling is far slower, so time it on a slice and scale up
+	constexpr std::size_t recompiled{ bindings / 50 };
+	timer.reset();
+	std::int64_t recompileSum{ 0 };
+	for(std::size_t i{ 0 }; i < recompiled; ++i)
+	{
+		Program fresh{};
+		compile(source, fresh, error);
+		std::int64_t result{};
+		evaluate(fresh, &values[i * variableCount], result);
+		recompileSum += result;
+	}
+	const double recompileSeconds{ timer.elapsed() * (bindings / recompiled) };
+
+	std::cout << "native C++:        " << nativeSeconds << " s\n"
+		  << "compiled once:     " << bytecodeSeconds << " s (" << bindings / bytecodeSeconds << " evaluations/s)\n"
+		  << "recompiled (est.): " << recompileSeconds << " s\n"
+		  << (nativeSum == bytecodeSum ? "results match\n" : "RESULTS DIFFER\n")
+		  << "checksum " << recompileSum << '\n';
+
+	return 0;
+}
@@ -0,0 +1,362 @@
+#include "expression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Deeper nesting than this is rejected rather than risking the parser's own call stack
+constexpr std::size_t maxNesting{ 1000 };
+
+// Programs needing at most this many stack slots evaluate without touching the heap
+constexpr std::size_t localStackSize{ 64 };
+
+constexpr std::int64_t int64Min{ std::numeric_limits<std::int64_t>::min() };
+
+// Wrapping arithmetic through unsigned, so overflow is defined
+std::int64_t wrapAdd(std::int64_t x, std::int64_t y)
+{
+	return static_cast<std::int64_t>(static_cast<std::uint64_t>(x) + static_cast<std::uint64_t>(y));
+}
+
+std::int64_t wrapSubtract(std::int64_t x, std::int64_t y)
+{
+	return static_cast<std::int64_t>(static_cast<std::uint64_t>(x) - static_cast<std::uint64_t>(y));
+}
+
+std::int64_t wrapMultiply(std::int64_t x, std::int64_t y)
+{
+	return static_cast<std::int64_t>(static_cast<std::uint64_t>(x) * static_cast<std::uint64_t>(y));
+}
+
+EvalStatus checkDivision(std::int64_t x, std::int64_t y)
+{
+	if(y == 0)
+		return EvalStatus::division_by_zero;
+	if(x == int64Min && y == -1)
+		return EvalStatus::overflow;
+
+	return EvalStatus::ok;
+}
+
+int Program::variableIndex(std::string_view name) const
+{
+	const auto found{ std::find(variables.begin(), variables.end(), name) };
+
+	return found == variables.end() ? -1 : static_cast<int>(found - variables.begin());
+}
+
+// Recursive descent straight to postfix code:
+//   expression := term (('+' | '-') term)*
+//   term       := unary (('*' | '/' | '%') unary)*
+//   unary      := '-' unary | '+' unary | primary
+//   primary    := number | name | '(' expression ')'
+class Parser
+{
+private:
+	std::string_view m_source{};
+	std::size_t m_position{ 0 };
+	std::size_t m_nesting{ 0 };
+	std::size_t m_stackDepth{ 0 };
+	Program& m_program;
+	std::string& m_error;
+
+	bool fail(const std::string& message)
+	{
+		m_error = message + " at position " + std::to_string(m_position);
+		return false;
+	}
+
+	char peek()
+	{
+		while(m_position < m_source.size() && (m_source[m_position] == ' ' || m_source[m_position] == '\t'))
+			++m_position;
+
+		return m_position < m_source.size() ? m_source[m_position] : '\0';
+	}
+
+	bool isConstant(std::size_t fromEnd) const
+	{
+		const auto& code{ m_program.code };
+		return code.size() > fromEnd && code[code.size() - 1 - fromEnd].op == OpCode::push_constant;
+	}
+
+	std::int64_t constantAt(std::size_t fromEnd) const
+	{
+		const auto& code{ m_program.code };
+		return m_program.constants[code[code.size() - 1 - fromEnd].operand];
+	}
+
+	void emitConstant(std::int64_t value)
+	{
+		m_program.constants.push_back(value);
+		m_program.code.push_back({ OpCode::push_constant, static_cast<std::uint32_t>(m_program.constants.size() - 1) });
+		m_program.maxStack = std::max(m_program.maxStack, ++m_stackDepth);
+	}
+
+	// Emits op, or folds it into a single constant when all its operands are constants
+	void emitOperator(OpCode op)
+	{
+		if(op == OpCode::negate)
+		{
+			if(isConstant(0))
+			{
+				const std::int64_t value{ wrapSubtract(0, constantAt(0)) };
+				m_program.code.pop_back();
+				--m_stackDepth;
+				emitConstant(value);
+				return;
+			}
+
+			m_program.code.push_back({ op, 0 });
+			return;
+		}
+
+		if(isConstant(0) && isConstant(1))
+		{
+			const std::int64_t x{ constantAt(1) };
+			const std::int64_t y{ constantAt(0) };
+			const bool isDivision{ op == OpCode::divide || op == OpCode::remainder };
+
+			// a failing division is left for evaluate() to report
+			if(!isDivision || checkDivision(x, y) == EvalStatus::ok)
+			{
+				std::int64_t value{};
+				switch(op)
+				{
+					case OpCode::add:       value = wrapAdd(x, y);          break;
+					case OpCode::subtract:  value = wrapSubtract(x, y);     break;
+					case OpCode::multiply:  value = wrapMultiply(x, y);     break;
+					case OpCode::divide:    value = x / y;                  break;
+					default:                value = x % y;                  break;
+				}
+
+				m_program.code.resize(m_program.code.size() - 2);
+				m_stackDepth -= 2;
+				emitConstant(value);
+				return;
+			}
+		}
+
+		m_program.code.push_back({ op, 0 });
+		--m_stackDepth;
+	}
+
+	// negated: the number is the direct operand of a unary minus, the only place 9223372036854775808 fits
+	bool parseNumber(bool negated = false)
+	{
+		std::uint64_t value{};
+		const char* begin{ m_source.data() + m_position };
+		const auto [end, ec]{ std::from_chars(begin, m_source.data() + m_source.size(), value) };
+		const std::uint64_t limit{ static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()) + (negated ? 1 : 0) };
+		if(ec != std::errc{} || value > limit)
+			return fail("Number out of range");
+
+		emitConstant(negated ? wrapSubtract(0, static_cast<std::int64_t>(value)) : static_cast<std::int64_t>(value));
+		m_position += static_cast<std::size_t>(end - begin);
+		return true;
+	}
+
+	bool parseName()
+	{
+		const std::size_t start{ m_position };
+		while(m_position < m_source.size()
+		      && (std::isalnum(static_cast<unsigned char>(m_source[m_position])) || m_source[m_position] == '_'))
+			++m_position;
+
+		const std::string_view name{ m_source.substr(start, m_position - start) };
+		int slot{ m_program.variableIndex(name) };
+		if(slot < 0)
+		{
+			m_program.variables.emplace_back(name);
+			slot = static_cast<int>(m_program.variables.size() - 1);
+		}
+
+		m_program.code.push_back({ OpCode::load_variable, static_cast<std::uint32_t>(slot) });
+		m_program.maxStack = std::max(m_program.maxStack, ++m_stackDepth);
+		return true;
+	}
+
+	bool parsePrimary()
+	{
+		const char c{ peek() };
+		if(c >= '0' && c <= '9')
+			return parseNumber();
+
+		if(std::isalpha(static_cast<unsigned char>(c)) || c == '_')
+			return parseName();
+
+		if(c == '(')
+		{
+			++m_position;
+			if(!parseExpression())
+				return false;
+			if(peek() != ')')
+				return fail("Expected ')'");
+
+			++m_position;
+			return true;
+		}
+
+		return fail(c == '\0' ? "Unexpected end of expression" : std::string{ "Unexpected '" } + c + "'");
+	}
+
+	bool parseUnary()
+	{
+		if(++m_nesting > maxNesting)
+			return fail("Expression nested too deeply");
+
+		bool ok{};
+		const char c{ peek() };
+		if(c == '-' || c == '+')
+		{
+			++m_position;
+			if(c == '-' && std::isdigit(static_cast<unsigned char>(peek())))
+			{
+				ok = parseNumber(true);
+			}
+			else
+			{
+				ok = parseUnary();
+				if(ok && c == '-')
+					emitOperator(OpCode::negate);
+			}
+		}
+		else
+		{
+			ok = parsePrimary();
+		}
+
+		--m_nesting;
+		return ok;
+	}
+
+	bool parseTerm()
+	{
+		if(!parseUnary())
+			return false;
+
+		while(true)
+		{
+			const char c{ peek() };
+			if(c != '*' && c != '/' && c != '%')
+				return true;
+
+			++m_position;
+			if(!parseUnary())
+				return false;
+
+			emitOperator(c == '*' ? OpCode::multiply : c == '/' ? OpCode::divide : OpCode::remainder);
+		}
+	}
+
+public:
+	Parser(std::string_view source, Program& program, std::string& error)
+		: m_source{ source }, m_program{ program }, m_error{ error }
+	{
+	}
+
+	bool parseExpression()
+	{
+		if(!parseTerm())
+			return false;
+
+		while(true)
+		{
+			const char c{ peek() };
+			if(c != '+' && c != '-')
+				return true;
+
+			++m_position;
+			if(!parseTerm())
+				return false;
+
+			emitOperator(c == '+' ? OpCode::add : OpCode::subtract);
+		}
+	}
+
+	bool parse()
+	{
+		if(!parseExpression())
+			return false;
+		if(peek() != '\0')
+			return fail(std::string{ "Unexpected '" } + m_source[m_position] + "'");
+
+		return true;
+	}
+};
+
+bool compile(std::string_view source, Program& program, std::string& error)
+{
+	program = Program{};
+	error.clear();
+
+	Parser parser{ source, program, error };
+	if(!parser.parse())
+	{
+		program = Program{};
+		return false;
+	}
+
+	return true;
+}
+
+EvalStatus evaluate(const Program& program, const std::int64_t* values, std::int64_t& result)
+{
+	std::int64_t localStack[localStackSize];
+	std::vector<std::int64_t> heapStack{};
+	std::int64_t* top{ localStack };           // one past the top of the stack
+	if(program.maxStack > localStackSize)
+	{
+		heapStack.resize(program.maxStack);
+		top = heapStack.data();
+	}
+
+	const std::int64_t* constants{ program.constants.data() };
+	for(const Instruction& instruction : program.code)
+	{
+		switch(instruction.op)
+		{
+			case OpCode::push_constant:
+				*top++ = constants[instruction.operand];
+				break;
+			case OpCode::load_variable:
+				*top++ = values[instruction.operand];
+				break;
+			case OpCode::add:
+				--top;
+				top[-1] = wrapAdd(top[-1], top[0]);
+				break;
+			case OpCode::subtract:
+				--top;
+				top[-1] = wrapSubtract(top[-1], top[0]);
+				break;
+			case OpCode::multiply:
+				--top;
+				top[-1] = wrapMultiply(top[-1], top[0]);
+				break;
+			case OpCode::divide:
+			case OpCode::remainder:
+			{
+				--top;
+				const EvalStatus status{ checkDivision(top[-1], top[0]) };
+				if(status != EvalStatus::ok)
+					return status;
+
+				top[-1] = instruction.op == OpCode::divide ? top[-1] / top[0] : top[-1] % top[0];
+				break;
+			}
+			case OpCode::negate:
+				top[-1] = wrapSubtract(0, top[-1]);
+				break;
+		}
+	}
+
+	result = top[-1];
+	return EvalStatus::ok;
+}
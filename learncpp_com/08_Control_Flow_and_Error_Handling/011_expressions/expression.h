@@ -0,0 +1,57 @@
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Integer infix expressions compiled once to stack bytecode and evaluated many times.
+// Grammar: + - * / % with the usual precedence, unary minus, parentheses, decimal literals
+// and variables ([A-Za-z_][A-Za-z0-9_]*). Arithmetic is 64-bit and wraps on overflow;
+// / and % truncate like C++ and fail on a zero divisor or INT64_MIN / -1.
+
+enum class OpCode : std::uint8_t
+{
+	push_constant,      // operand: index into constants
+	load_variable,      // operand: variable slot
+	add,
+	subtract,
+	multiply,
+	divide,
+	remainder,
+	negate,
+};
+
+struct Instruction
+{
+	OpCode op{};
+	std::uint32_t operand{};
+};
+
+struct Program
+{
+	std::vector<Instruction> code{};
+	std::vector<std::int64_t> constants{};
+	std::vector<std::string> variables{};       // slot i is bound to values[i] in evaluate()
+	std::size_t maxStack{ 0 };
+
+	// Slot of a variable, or -1 when the expression does not use it
+	int variableIndex(std::string_view name) const;
+};
+
+enum class EvalStatus
+{
+	ok,
+	division_by_zero,
+	overflow,           // INT64_MIN / -1 or INT64_MIN % -1
+};
+
+// Returns false and describes the first problem (with its position) in error
+bool compile(std::string_view source, Program& program, std::string& error);
+
+// values must hold one value per entry of program.variables
+EvalStatus evaluate(const Program& program, const std::int64_t* values, std::int64_t& result);
+
+#endif
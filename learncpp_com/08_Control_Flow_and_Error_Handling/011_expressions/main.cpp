@@ -0,0 +1,71 @@
+// Generalizes calculate() from 000_switch_calc.cpp: instead of two integers and one operator
+// it takes a whole expression such as "(a + b) * c % 7", compiles it once, then asks for the variables.
+// Usage: main [expression]
+
+// Build: g++ -std=c++17 -O2 main.cpp expression.cpp
+
+#include "expression.h"
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+std::int64_t getValue(const std::string& name)
+{
+	while(true)
+	{
+		std::cout << "Enter " << name << ": ";
+		std::int64_t input{};
+		if(std::cin >> input)
+			return input;
+
+		if(std::cin.eof())
+			return 0;
+
+		std::cin.clear();
+		std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::string source{};
+	if(argc > 1)
+	{
+		source = argv[1];
+	}
+	else
+	{
+		std::cout << "Enter an expression: ";
+		std::getline(std::cin, source);
+	}
+
+	Program program{};
+	std::string error{};
+	if(!compile(source, program, error))
+	{
+		std::cout << error << '\n';
+		return 1;
+	}
+
+	std::vector<std::int64_t> values(program.variables.size());
+	for(std::size_t i{ 0 }; i < values.size(); ++i)
+		values[i] = getValue(program.variables[i]);
+
+	std::int64_t result{};
+	switch(evaluate(program, values.data(), result))
+	{
+		case EvalStatus::ok:
+			std::cout << result << '\n';
+			return 0;
+		case EvalStatus::division_by_zero:
+			std::cout << "Division by zero.\n";
+			return 1;
+		case EvalStatus::overflow:
+			std::cout << "Division overflows.\n";
+			return 1;
+	}
+
+	return 1;
+}
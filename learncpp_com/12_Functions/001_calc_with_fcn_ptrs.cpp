@@ -13,9 +13,19 @@
 // Modify your main() function to call getArithmeticFunction(). 
 // Call the return value from that function with your inputs and print the result.
 
+// The operations report overflow and division by zero instead of invoking undefined behavior (checked.h from 008_calc),
+// so they return the result together with a CheckedStatus.
+// The call goes through CachedEvaluator (008_calc/result_cache.h) with caching off, since one query per run
+// can never hit; 008_calc/calc_stream.cpp --cache shows the cache on repeated input.
+
+// Build: g++ -std=c++17 001_calc_with_fcn_ptrs.cpp
+
+#include "008_calc/checked.h"
+#include "008_calc/result_cache.h"
 #include <functional>
 #include <iostream>
 
+constexpr bool cacheResults{ false };
 
 int getInteger()
 {
@@ -40,27 +50,27 @@ char getOperation()
 	return op;
 }
 
-int add(int x, int y)
+Checked<int> add(int x, int y)
 {
-	return x + y;
+	return checkedAdd<Reporting>(x, y);
 }
 
-int subtract(int x, int y)
+Checked<int> subtract(int x, int y)
 {
-	return x - y;
+	return checkedSubtract<Reporting>(x, y);
 }
 
-int multiply(int x, int y)
+Checked<int> multiply(int x, int y)
 {
-	return x * y;
+	return checkedMultiply<Reporting>(x, y);
 }
 
-int divide(int x, int y)
+Checked<int> divide(int x, int y)
 {
-	return x / y;
+	return checkedDivide<Reporting>(x, y);
 }
 
-using ArithmeticFunction = std::function<int(int, int)>;
+using ArithmeticFunction = std::function<Checked<int>(int, int)>;
 
 ArithmeticFunction getArithmeticFunction(char op)
 {
@@ -71,6 +81,8 @@ ArithmeticFunction getArithmeticFunction(char op)
 		case '*':   return &multiply;
 		case '/':   return &divide;
 	}
+
+	return nullptr;
 }
 
 int main()
@@ -79,9 +91,23 @@ int main()
 	char op{ getOperation() };
 	int y{ getInteger() };
 
-	ArithmeticFunction fcn{ getArithmeticFunction(op) };
-	std::cout << x << ' ' << op << ' ' << y << " = " << fcn(x, y) << '\n';
+	CalcCache<cacheResults, int, Checked<int>, char> cache{ 1024 };
+	CachedEvaluator evaluator{ cache, [](int a, char o, int b) { return getArithmeticFunction(o)(a, b); } };
+	const Checked<int> result{ evaluator(x, op, y) };
+
+	switch(result.status)
+	{
+		case CheckedStatus::ok:
+			std::cout << x << ' ' << op << ' ' << y << " = " << result.value << '\n';
+			return 0;
+		case CheckedStatus::overflow:
+			std::cout << x << ' ' << op << ' ' << y << " overflows an int.\n";
+			return 1;
+		case CheckedStatus::division_by_zero:
+			std::cout << "Can not divide by zero.\n";
+			return 1;
+	}
 
-	return 0;
+	return 1;
 }
 
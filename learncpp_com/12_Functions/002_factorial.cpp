@@ -1,9 +1,15 @@
 // Write a recursive function called factorial that returns the factorial of the input.
 // Test it with the first 7 factorials.
 
+// factorial() takes any integer type; with BigInt from 009_bigint it no longer overflows at 13!.
+
+// Build: g++ -std=c++17 002_factorial.cpp 009_bigint/bigint.cpp
+
+#include "009_bigint/bigint.h"
 #include <iostream>
 
-int factorial(int n)
+template <typename T>
+T factorial(T n)
 {
 	if(n > 1)
 	{
@@ -20,5 +26,7 @@ int main()
 		std::cout << factorial(i) << '\n'; 
 	}	
 
+	std::cout << "25! = " << factorial(BigInt{ 25 }) << '\n';
+
 	return 0;
 }
@@ -0,0 +1,64 @@
+#ifndef ARITHMETIC_H
+#define ARITHMETIC_H
+
+#include "checked.h"
+#include <cstdint>
+
+// The four operations of 001_calc_with_fcn_ptrs.cpp with every input defined:
+// +, - and * wrap modulo 2^32, x / 0 is 0 and INT_MIN / -1 wraps to INT_MIN.
+// The batch kernels in arithmetic_batch.cpp produce exactly these results.
+
+enum class Operation
+{
+	add,
+	subtract,
+	multiply,
+	divide,
+};
+
+// '+', '-', '*' or '/'; false for anything else
+constexpr bool toOperation(char symbol, Operation& op)
+{
+	switch(symbol)
+	{
+		case '+':   op = Operation::add;        return true;
+		case '-':   op = Operation::subtract;   return true;
+		case '*':   op = Operation::multiply;   return true;
+		case '/':   op = Operation::divide;     return true;
+	}
+
+	return false;
+}
+
+constexpr char toSymbol(Operation op)
+{
+	constexpr char symbols[]{ '+', '-', '*', '/' };
+	return symbols[static_cast<int>(op)];
+}
+
+inline int add(int x, int y)
+{
+	return checkedAdd<Wrapping>(x, y);
+}
+
+inline int subtract(int x, int y)
+{
+	return checkedSubtract<Wrapping>(x, y);
+}
+
+inline int multiply(int x, int y)
+{
+	return checkedMultiply<Wrapping>(x, y);
+}
+
+// Same result as checkedDivide<Wrapping>, without a branch: a zero divisor is replaced by 1 and its quotient masked to 0.
+// Dividing in 64 bits keeps INT_MIN / -1 from trapping.
+inline int divide(int x, int y)
+{
+	const std::uint32_t nonZero{ y != 0 };
+	const std::int64_t quotient{ static_cast<std::int64_t>(x) / (y + static_cast<int>(1 - nonZero)) };
+
+	return static_cast<int>(static_cast<std::uint32_t>(quotient) & (0u - nonZero));
+}
+
+#endif
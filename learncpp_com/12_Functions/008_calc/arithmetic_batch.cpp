@@ -0,0 +1,170 @@
+#include "arithmetic_batch.h"
+
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ARITHMETIC_X86 1
+#endif
+
+// Every kernel is a template on the operator, so the switch in applyBatch() is the only dispatch
+// and each loop body is a handful of instructions.
+
+template <Operation op>
+std::size_t applyScalar(const int* x, const int* y, int* out, std::size_t count)
+{
+	std::size_t zeroDivisors{ 0 };
+	for(std::size_t i{ 0 }; i < count; ++i)
+	{
+		const int a{ x[i] };
+		const int b{ y[i] };
+		if constexpr(op == Operation::add)
+			out[i] = add(a, b);
+		else if constexpr(op == Operation::subtract)
+			out[i] = subtract(a, b);
+		else if constexpr(op == Operation::multiply)
+			out[i] = multiply(a, b);
+		else
+		{
+			zeroDivisors += (b == 0);
+			out[i] = divide(a, b);
+		}
+	}
+
+	return zeroDivisors;
+}
+
+#ifdef ARITHMETIC_X86
+
+// Division has no integer SIMD instruction. Each quotient is computed in double and truncated instead:
+// 32-bit operands are exact in double and the rounded quotient never crosses an integer,
+// so truncation gives the exact C++ quotient. INT_MIN / -1 = 2^31 converts to the
+// "integer indefinite" 0x80000000, which is the wrapped INT_MIN the scalar divide() returns.
+// Zero divisors are replaced by 1 (y - mask, with mask all ones) and the lane is cleared afterwards.
+
+// SSE2 has no 32-bit low multiply: multiply the even and odd lanes as 64-bit and keep the low halves
+__attribute__((target("sse2")))
+inline __m128i multiplySse2(__m128i a, __m128i b)
+{
+	const __m128i even{ _mm_mul_epu32(a, b) };
+	const __m128i odd{ _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32)) };
+
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, 0x08), _mm_shuffle_epi32(odd, 0x08));
+}
+
+__attribute__((target("sse2")))
+inline __m128i divideSse2(__m128i a, __m128i b, __m128i zeroMask)
+{
+	const __m128i safe{ _mm_sub_epi32(b, zeroMask) };
+
+	const __m128d low{ _mm_div_pd(_mm_cvtepi32_pd(a), _mm_cvtepi32_pd(safe)) };
+	const __m128d high{ _mm_div_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(a, 0x4E)),
+				       _mm_cvtepi32_pd(_mm_shuffle_epi32(safe, 0x4E))) };
+	const __m128i quotient{ _mm_unpacklo_epi64(_mm_cvttpd_epi32(low), _mm_cvttpd_epi32(high)) };
+
+	return _mm_andnot_si128(zeroMask, quotient);
+}
+
+template <Operation op>
+__attribute__((target("sse2")))
+std::size_t applySse2(const int* x, const int* y, int* out, std::size_t count)
+{
+	std::size_t zeroDivisors{ 0 };
+	std::size_t i{ 0 };
+	for(; i + 4 <= count; i += 4)
+	{
+		const __m128i a{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)) };
+		const __m128i b{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + i)) };
+
+		__m128i result{};
+		if constexpr(op == Operation::add)
+			result = _mm_add_epi32(a, b);
+		else if constexpr(op == Operation::subtract)
+			result = _mm_sub_epi32(a, b);
+		else if constexpr(op == Operation::multiply)
+			result = multiplySse2(a, b);
+		else
+		{
+			const __m128i zeroMask{ _mm_cmpeq_epi32(b, _mm_setzero_si128()) };
+			zeroDivisors += static_cast<std::size_t>(__builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(zeroMask))));
+			result = divideSse2(a, b, zeroMask);
+		}
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), result);
+	}
+
+	return zeroDivisors + applyScalar<op>(x + i, y + i, out + i, count - i);
+}
+
+__attribute__((target("avx2")))
+inline __m256i divideAvx2(__m256i a, __m256i b, __m256i zeroMask)
+{
+	const __m256i safe{ _mm256_sub_epi32(b, zeroMask) };
+
+	const __m256d low{ _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(a)),
+					 _mm256_cvtepi32_pd(_mm256_castsi256_si128(safe))) };
+	const __m256d high{ _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(a, 1)),
+					  _mm256_cvtepi32_pd(_mm256_extracti128_si256(safe, 1))) };
+	const __m256i quotient{ _mm256_set_m128i(_mm256_cvttpd_epi32(high), _mm256_cvttpd_epi32(low)) };
+
+	return _mm256_andnot_si256(zeroMask, quotient);
+}
+
+template <Operation op>
+__attribute__((target("avx2")))
+std::size_t applyAvx2(const int* x, const int* y, int* out, std::size_t count)
+{
+	std::size_t zeroDivisors{ 0 };
+	std::size_t i{ 0 };
+	for(; i + 8 <= count; i += 8)
+	{
+		const __m256i a{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i)) };
+		const __m256i b{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i)) };
+
+		__m256i result{};
+		if constexpr(op == Operation::add)
+			result = _mm256_add_epi32(a, b);
+		else if constexpr(op == Operation::subtract)
+			result = _mm256_sub_epi32(a, b);
+		else if constexpr(op == Operation::multiply)
+			result = _mm256_mullo_epi32(a, b);
+		else
+		{
+			const __m256i zeroMask{ _mm256_cmpeq_epi32(b, _mm256_setzero_si256()) };
+			zeroDivisors += static_cast<std::size_t>(__builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(zeroMask))));
+			result = divideAvx2(a, b, zeroMask);
+		}
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), result);
+	}
+
+	return zeroDivisors + applyScalar<op>(x + i, y + i, out + i, count - i);
+}
+
+#endif
+
+template <Operation op>
+std::size_t applyOperation(const int* x, const int* y, int* out, std::size_t count)
+{
+#ifdef ARITHMETIC_X86
+	if(__builtin_cpu_supports("avx2"))
+		return applyAvx2<op>(x, y, out, count);
+	if(__builtin_cpu_supports("sse2"))
+		return applySse2<op>(x, y, out, count);
+#endif
+
+	return applyScalar<op>(x, y, out, count);
+}
+
+std::size_t applyBatch(Operation op, const int* x, const int* y, int* out, std::size_t count)
+{
+	switch(op)
+	{
+		case Operation::add:        return applyOperation<Operation::add>(x, y, out, count);
+		case Operation::subtract:   return applyOperation<Operation::subtract>(x, y, out, count);
+		case Operation::multiply:   return applyOperation<Operation::multiply>(x, y, out, count);
+		case Operation::divide:     return applyOperation<Operation::divide>(x, y, out, count);
+	}
+
+	return 0;
+}
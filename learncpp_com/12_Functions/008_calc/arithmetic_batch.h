@@ -0,0 +1,13 @@
+#ifndef ARITHMETIC_BATCH_H
+#define ARITHMETIC_BATCH_H
+
+#include "arithmetic.h"
+#include <cstddef>
+
+	// out[i] = op(x[i], y[i]) for every i, with the results of the scalar functions in arithmetic.h.
+	// The operator is dispatched once for the whole batch; each operator has its own AVX2 and SSE2 kernel,
+	// picked at runtime, and a scalar loop elsewhere. out may be the same array as x or y.
+	// Returns how many lanes had a zero divisor (always 0 unless op is divide); those lanes are set to 0.
+	std::size_t applyBatch(Operation op, const int* x, const int* y, int* out, std::size_t count);
+
+#endif
@@ -0,0 +1,121 @@
+// Check applyBatch() against the scalar functions and compare it with calling
+// a std::function<int(int, int)> for every pair, as 001_calc_with_fcn_ptrs.cpp does.
+
+// Build: g++ -std=c++17 -O2 benchmark.cpp arithmetic_batch.cpp
+
+#include "arithmetic.h"
+#include "arithmetic_batch.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/timer.h"
+#include <climits>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using ArithmeticFunction = std::function<int(int, int)>;
+
+ArithmeticFunction getArithmeticFunction(Operation op)
+{
+	switch(op)
+	{
+		case Operation::add:        return &add;
+		case Operation::subtract:   return &subtract;
+		case Operation::multiply:   return &multiply;
+		case Operation::divide:     return &divide;
+	}
+
+	return nullptr;
+}
+
+bool check(Operation op)
+{
+	// edge cases first, then random values with plenty of zero divisors
+	std::vector<int> x{ INT_MIN, INT_MIN, INT_MAX, INT_MAX, -7, 7, 0, 1, -1, 5, INT_MIN, 0, 3 };
+	std::vector<int> y{ -1, 1, 1, -1, 2, -2, 0, 0, INT_MIN, 0, INT_MIN, INT_MIN, INT_MAX };
+	std::mt19937 mt{ 42 };
+	std::uniform_int_distribution<int> any{ INT_MIN, INT_MAX };
+	std::uniform_int_distribution<int> small{ -3, 3 };
+	for(int i{ 0 }; i < 100'003; ++i)
+	{
+		x.push_back(any(mt));
+		y.push_back(i % 2 ? any(mt) : small(mt));
+	}
+
+	std::vector<int> out(x.size());
+	const std::size_t zeroDivisors{ applyBatch(op, x.data(), y.data(), out.data(), x.size()) };
+
+	const ArithmeticFunction fcn{ getArithmeticFunction(op) };
+	std::size_t expectedZeroDivisors{ 0 };
+	for(std::size_t i{ 0 }; i < x.size(); ++i)
+	{
+		if(op == Operation::divide && y[i] == 0)
+			++expectedZeroDivisors;
+
+		if(out[i] != fcn(x[i], y[i]))
+		{
+			std::cout << x[i] << ' ' << toSymbol(op) << ' ' << y[i] << ": batch " << out[i]
+				  << ", scalar " << fcn(x[i], y[i]) << '\n';
+			return false;
+		}
+	}
+
+	return zeroDivisors == expectedZeroDivisors;
+}
+
+int main()
+{
+	constexpr Operation operations[]{ Operation::add, Operation::subtract, Operation::multiply, Operation::divide };
+	for(const Operation op : operations)
+	{
+		if(!check(op))
+		{
+			std::cout << "Mismatch for " << toSymbol(op) << '\n';
+			return 1;
+		}
+	}
+	std::cout << "Batch results match the scalar functions.\n\n";
+
+	constexpr std::size_t count{ 1 << 20 };
+	constexpr int rounds{ 50 };
+	std::mt19937 mt{ 7 };
+	std::uniform_int_distribution<int> dist{ -100'000, 100'000 };
+	std::vector<int> x(count);
+	std::vector<int> y(count);
+	std::vector<int> out(count);
+	for(std::size_t i{ 0 }; i < count; ++i)
+	{
+		x[i] = dist(mt);
+		y[i] = dist(mt);
+	}
+
+	for(const Operation op : operations)
+	{
+		const ArithmeticFunction fcn{ getArithmeticFunction(op) };
+
+		Timer timer{};
+		long long checksum{ 0 };
+		for(int round{ 0 }; round < rounds; ++round)
+		{
+			for(std::size_t i{ 0 }; i < count; ++i)
+				out[i] = fcn(x[i], y[i]);
+			checksum += out[round];
+		}
+		const double perElement{ timer.elapsed() };
+
+		timer.reset();
+		for(int round{ 0 }; round < rounds; ++round)
+		{
+			applyBatch(op, x.data(), y.data(), out.data(), count);
+			checksum -= out[round];
+		}
+		const double batched{ timer.elapsed() };
+
+		const double elements{ static_cast<double>(count) * rounds };
+		std::cout << toSymbol(op) << "  std::function: " << elements / perElement / 1e6 << " M/s   batch: "
+			  << elements / batched / 1e6 << " M/s   (" << perElement / batched << "x)"
+			  << (checksum == 0 ? "" : "  CHECKSUM DIFFERS") << '\n';
+	}
+
+	return 0;
+}
@@ -0,0 +1,118 @@
+// Repetitive calculator traffic (90% of requests from 1,000 hot triples, the rest from a wide range)
+// evaluated with and without the result cache on 1, 2, 4, ... threads, for two evaluators:
+// the function pointer table of dispatch.h, and compiling "x op y" with the bytecode engine
+// from 08_Control_Flow_and_Error_Handling/011_expressions as a request parser would.
+
+// Build: g++ -std=c++17 -O2 -pthread cache_benchmark.cpp ../../08_Control_Flow_and_Error_Handling/011_expressions/expression.cpp
+
+#include "arithmetic.h"
+#include "dispatch.h"
+#include "result_cache.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/timer.h"
+#include "../../08_Control_Flow_and_Error_Handling/011_expressions/expression.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+std::int64_t evaluateFunction(std::int64_t x, Operation op, std::int64_t y)
+{
+	return getArithmeticPointer(op)(static_cast<int>(x), static_cast<int>(y));
+}
+
+std::int64_t evaluateExpression(std::int64_t x, Operation op, std::int64_t y)
+{
+	const std::string source{ std::to_string(x) + ' ' + toSymbol(op) + " (" + std::to_string(y) + ')' };
+	Program program{};
+	std::string error{};
+	std::int64_t result{ 0 };
+	if(compile(source, program, error))
+		evaluate(program, nullptr, result);
+
+	return result;
+}
+
+using Request = CalcKey<std::int64_t, Operation>;
+
+std::vector<Request> makeRequests(std::size_t count, std::uint64_t seed)
+{
+	std::mt19937_64 mt{ seed };
+	std::uniform_int_distribution<std::int64_t> value{ -100'000, 100'000 };
+	std::vector<Request> hot(1000);
+	for(Request& key : hot)
+		key = { value(mt), value(mt), static_cast<Operation>(mt() % 4) };
+
+	std::vector<Request> requests(count);
+	for(Request& request : requests)
+		request = mt() % 10 ? hot[mt() % hot.size()] : Request{ value(mt), value(mt), static_cast<Operation>(mt() % 4) };
+
+	return requests;
+}
+
+// Requests per second over all threads, and a checksum of every result
+template <typename Cache, typename Evaluate>
+double run(Cache& cache, Evaluate evaluate, std::size_t threads, std::size_t perThread, std::int64_t& checksum)
+{
+	std::vector<std::vector<Request>> requests(threads);
+	for(std::size_t t{ 0 }; t < threads; ++t)
+		requests[t] = makeRequests(perThread, t + 1);
+
+	std::vector<std::int64_t> sums(threads);
+	Timer timer{};
+	std::vector<std::thread> workers{};
+	for(std::size_t t{ 0 }; t < threads; ++t)
+	{
+		workers.emplace_back([&, t]
+		{
+			CachedEvaluator<Cache, Evaluate> evaluator{ cache, evaluate };
+			std::int64_t sum{ 0 };
+			for(const Request& request : requests[t])
+				sum += evaluator(request.x, request.op, request.y);
+			sums[t] = sum;
+		});
+	}
+	for(std::thread& worker : workers)
+		worker.join();
+	const double seconds{ timer.elapsed() };
+
+	checksum = 0;
+	for(const std::int64_t sum : sums)
+		checksum += sum;
+
+	return static_cast<double>(threads * perThread) / seconds;
+}
+
+template <typename Evaluate>
+void compare(const char* name, Evaluate evaluate, std::size_t perThread)
+{
+	std::cout << name << '\n';
+
+	const std::size_t hardware{ std::max(1u, std::thread::hardware_concurrency()) };
+	for(std::size_t threads{ 1 }; threads <= hardware; threads *= 2)
+	{
+		NoCache none{};
+		CalcCache<true, std::int64_t, std::int64_t, Operation> cache{ 16 * 1024 };
+
+		std::int64_t uncachedSum{};
+		std::int64_t cachedSum{};
+		const double uncached{ run(none, evaluate, threads, perThread, uncachedSum) };
+		const double cached{ run(cache, evaluate, threads, perThread, cachedSum) };
+
+		const CacheStats stats{ cache.stats() };
+		std::cout << "  " << threads << " thread(s): no cache " << uncached / 1e6 << " M req/s, cache " << cached / 1e6
+			  << " M req/s  (hits " << stats.hits << ", misses " << stats.misses << ", evictions " << stats.evictions
+			  << ')' << (uncachedSum == cachedSum ? "" : "  RESULTS DIFFER") << '\n';
+	}
+}
+
+int main()
+{
+	compare("getArithmeticPointer():", evaluateFunction, 2'000'000);
+	compare("compile and evaluate \"x op y\":", evaluateExpression, 500'000);
+
+	return 0;
+}
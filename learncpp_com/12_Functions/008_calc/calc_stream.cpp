@@ -0,0 +1,85 @@
+// Usage: calc_stream [--double] [--threads N] [--cache N] [file]     compute every "a op b" line of file or stdin
+//        calc_stream --generate count [--double]                   write count random lines to stdout
+// Without --double the lines are integer expressions (+ - * / %), with it floating point (+ - * /).
+// --cache N answers integer lines through a result cache of N entries.
+
+// Build: g++ -std=c++17 -O2 -pthread calc_stream.cpp stream.cpp
+
+#include "stream.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/timer.h"
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+
+void generate(unsigned long long count, StreamNumbers numbers)
+{
+	std::mt19937_64 mt{ 2024 };
+	std::uniform_int_distribution<int> integer{ -1'000'000, 1'000'000 };
+	std::uniform_real_distribution<double> floating{ -1000.0, 1000.0 };
+	const std::string symbols{ numbers == StreamNumbers::integer ? "+-*/%" : "+-*/" };
+	std::uniform_int_distribution<std::size_t> symbol{ 0, symbols.size() - 1 };
+
+	std::string line{};
+	for(unsigned long long i{ 0 }; i < count; ++i)
+	{
+		if(numbers == StreamNumbers::integer)
+			line = std::to_string(integer(mt)) + ' ' + symbols[symbol(mt)] + ' ' + std::to_string(integer(mt) % 1000);
+		else
+			line = std::to_string(floating(mt)) + ' ' + symbols[symbol(mt)] + ' ' + std::to_string(floating(mt));
+
+		line.push_back('\n');
+		std::fwrite(line.data(), 1, line.size(), stdout);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	StreamNumbers numbers{ StreamNumbers::integer };
+	const char* path{ nullptr };
+	std::size_t threads{ 1 };
+	std::size_t cacheCapacity{ 0 };
+	unsigned long long generateCount{ 0 };
+	for(int i{ 1 }; i < argc; ++i)
+	{
+		const std::string arg{ argv[i] };
+		if(arg == "--double")
+			numbers = StreamNumbers::floating;
+		else if(arg == "--threads" && i + 1 < argc)
+			threads = std::stoul(argv[++i]);
+		else if(arg == "--cache" && i + 1 < argc)
+			cacheCapacity = std::stoul(argv[++i]);
+		else if(arg == "--generate" && i + 1 < argc)
+			generateCount = std::stoull(argv[++i]);
+		else
+			path = argv[i];
+	}
+
+	if(generateCount)
+	{
+		generate(generateCount, numbers);
+		return 0;
+	}
+
+	std::FILE* in{ path ? std::fopen(path, "rb") : stdin };
+	if(!in)
+	{
+		std::cerr << "Can not open " << path << '\n';
+		return 1;
+	}
+
+	Timer timer{};
+	const StreamStats stats{ calculateStream(in, stdout, numbers, threads, cacheCapacity) };
+	const double seconds{ timer.elapsed() };
+
+	if(path)
+		std::fclose(in);
+
+	std::cerr << stats.lines << " lines, " << stats.invalid << " invalid, " << stats.divisionByZero
+		  << " division by zero, " << seconds << " s (" << (seconds > 0 ? stats.lines / seconds * 60 / 1e6 : 0.0)
+		  << "M lines/min)\n";
+	if(cacheCapacity > 0)
+		std::cerr << stats.cacheHits << " cache hits\n";
+
+	return 0;
+}
@@ -0,0 +1,152 @@
+#ifndef CHECKED_H
+#define CHECKED_H
+
+#include <limits>
+#include <type_traits>
+
+// Integer arithmetic with defined behavior for every input, built on __builtin_*_overflow.
+// What happens on overflow or a zero divisor is a policy chosen at compile time:
+//   Wrapping    two's complement wrap-around, x / 0 == 0; compiles to the plain instruction, nothing is checked
+//   Saturating  clamps to the limit in the direction of the true result, x / 0 saturates by the sign of x
+//   Reporting   returns the wrapped value together with a CheckedStatus
+// Every function works for any built-in integer type, signed or unsigned.
+
+enum class CheckedStatus
+{
+	ok,
+	overflow,
+	division_by_zero,
+};
+
+template <typename T>
+struct Checked
+{
+	T value{};
+	CheckedStatus status{ CheckedStatus::ok };
+
+	constexpr bool ok() const { return status == CheckedStatus::ok; }
+};
+
+struct Wrapping
+{
+	template <typename T>
+	using Result = T;
+
+	template <typename T>
+	static constexpr T ok(T value) { return value; }
+
+	template <typename T>
+	static constexpr T overflow(T wrapped, bool) { return wrapped; }
+
+	template <typename T>
+	static constexpr T divisionByZero(T) { return 0; }
+};
+
+struct Saturating
+{
+	template <typename T>
+	using Result = T;
+
+	template <typename T>
+	static constexpr T ok(T value) { return value; }
+
+	// positive: the true result is above the maximum rather than below the minimum
+	template <typename T>
+	static constexpr T overflow(T, bool positive)
+	{
+		return positive ? std::numeric_limits<T>::max() : std::numeric_limits<T>::min();
+	}
+
+	template <typename T>
+	static constexpr T divisionByZero(T x)
+	{
+		return x == 0 ? T{ 0 } : overflow(x, x > 0);
+	}
+};
+
+struct Reporting
+{
+	template <typename T>
+	using Result = Checked<T>;
+
+	template <typename T>
+	static constexpr Checked<T> ok(T value) { return { value, CheckedStatus::ok }; }
+
+	template <typename T>
+	static constexpr Checked<T> overflow(T wrapped, bool) { return { wrapped, CheckedStatus::overflow }; }
+
+	template <typename T>
+	static constexpr Checked<T> divisionByZero(T) { return { 0, CheckedStatus::division_by_zero }; }
+};
+
+template <typename Policy, typename T>
+constexpr typename Policy::template Result<T> checkedAdd(T x, T y)
+{
+	T result{};
+	if(__builtin_add_overflow(x, y, &result))
+		return Policy::overflow(result, std::is_unsigned_v<T> || y > 0);
+
+	return Policy::ok(result);
+}
+
+template <typename Policy, typename T>
+constexpr typename Policy::template Result<T> checkedSubtract(T x, T y)
+{
+	T result{};
+	if(__builtin_sub_overflow(x, y, &result))
+		return Policy::overflow(result, std::is_signed_v<T> && y < 0);
+
+	return Policy::ok(result);
+}
+
+template <typename Policy, typename T>
+constexpr typename Policy::template Result<T> checkedMultiply(T x, T y)
+{
+	T result{};
+	if(__builtin_mul_overflow(x, y, &result))
+		return Policy::overflow(result, (x < 0) == (y < 0));
+
+	return Policy::ok(result);
+}
+
+// Truncates like built-in division; the only overflow is the minimum divided by -1
+template <typename Policy, typename T>
+constexpr typename Policy::template Result<T> checkedDivide(T x, T y)
+{
+	if(y == 0)
+		return Policy::divisionByZero(x);
+
+	if constexpr(std::is_signed_v<T>)
+	{
+		if(x == std::numeric_limits<T>::min() && y == -1)
+			return Policy::overflow(x, true);
+	}
+
+	return Policy::ok(static_cast<T>(x / y));
+}
+
+// Takes the sign of x like built-in %; the minimum % -1 is 0, which is exact, so only a zero divisor fails
+template <typename Policy, typename T>
+constexpr typename Policy::template Result<T> checkedRemainder(T x, T y)
+{
+	if(y == 0)
+		return Policy::divisionByZero(x);
+
+	if constexpr(std::is_signed_v<T>)
+	{
+		if(y == -1)
+			return Policy::ok(T{ 0 });
+	}
+
+	return Policy::ok(static_cast<T>(x % y));
+}
+
+static_assert(checkedAdd<Wrapping>(std::numeric_limits<int>::max(), 1) == std::numeric_limits<int>::min());
+static_assert(checkedSubtract<Saturating>(std::numeric_limits<int>::min(), 1) == std::numeric_limits<int>::min());
+static_assert(checkedMultiply<Saturating>(-65536, 65536) == std::numeric_limits<int>::min());
+static_assert(checkedSubtract<Saturating>(1u, 2u) == 0u);
+static_assert(checkedDivide<Reporting>(1, 0).status == CheckedStatus::division_by_zero);
+static_assert(checkedDivide<Saturating>(std::numeric_limits<int>::min(), -1) == std::numeric_limits<int>::max());
+static_assert(checkedRemainder<Reporting>(std::numeric_limits<int>::min(), -1).ok());
+
+#endif
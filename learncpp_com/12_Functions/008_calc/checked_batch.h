@@ -0,0 +1,123 @@
+#ifndef CHECKED_BATCH_H
+#define CHECKED_BATCH_H
+
+#include "arithmetic.h"
+#include "checked.h"
+#include "dispatch.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+// Batch form of checked.h: instead of a status per element, each block of checkedBlockSize elements
+// gets one byte of flags. Overflow and zero divisors are folded into the flags with OR and the
+// element itself is selected with a conditional move, so the loops never branch on the data
+// and the compiler is free to vectorize them (GCC does from -O3).
+
+inline constexpr std::size_t checkedBlockSize{ 256 };
+
+enum CheckedBlockFlags : std::uint8_t
+{
+	block_overflow = 1,
+	block_division_by_zero = 2,
+};
+
+constexpr std::size_t checkedBlockCount(std::size_t count)
+{
+	return (count + checkedBlockSize - 1) / checkedBlockSize;
+}
+
+// out[i] = op(x[i], y[i]) under Policy, which must be Wrapping or Saturating;
+// blockFlags needs checkedBlockCount(count) bytes
+template <typename Policy, Operation op, typename T>
+void checkedBatch(const T* x, const T* y, T* out, std::size_t count, std::uint8_t* blockFlags)
+{
+	static_assert(std::is_same_v<Policy, Wrapping> || std::is_same_v<Policy, Saturating>,
+		      "The batch form reports through block flags; use Wrapping or Saturating");
+	constexpr bool saturate{ std::is_same_v<Policy, Saturating> };
+	constexpr T max{ std::numeric_limits<T>::max() };
+	constexpr T min{ std::numeric_limits<T>::min() };
+
+	for(std::size_t first{ 0 }; first < count; first += checkedBlockSize)
+	{
+		const std::size_t last{ first + checkedBlockSize < count ? first + checkedBlockSize : count };
+		unsigned overflow{ 0 };
+		unsigned zeroDivisor{ 0 };
+
+		for(std::size_t i{ first }; i < last; ++i)
+		{
+			const T a{ x[i] };
+			const T b{ y[i] };
+			T result{};
+			if constexpr(op != Operation::divide && sizeof(T) < sizeof(std::int64_t) && (std::is_signed_v<T> || sizeof(T) < 4))
+			{
+				// narrow types: the exact result fits in 64 bits, and a clamp vectorizes where the builtins do not
+				const auto wide{ op == Operation::add        ? std::int64_t{ a } + b
+						 : op == Operation::subtract ? std::int64_t{ a } - b
+									     : std::int64_t{ a } * b };
+				const std::int64_t clamped{ std::min<std::int64_t>(std::max<std::int64_t>(wide, min), max) };
+				overflow |= clamped != wide;
+				result = static_cast<T>(saturate ? clamped : wide);
+			}
+			else if constexpr(op == Operation::add)
+			{
+				const bool over{ __builtin_add_overflow(a, b, &result) };
+				overflow |= over;
+				if constexpr(saturate)
+					result = over ? (std::is_unsigned_v<T> || b > 0 ? max : min) : result;
+			}
+			else if constexpr(op == Operation::subtract)
+			{
+				const bool over{ __builtin_sub_overflow(a, b, &result) };
+				overflow |= over;
+				if constexpr(saturate)
+					result = over ? (std::is_signed_v<T> && b < 0 ? max : min) : result;
+			}
+			else if constexpr(op == Operation::multiply)
+			{
+				const bool over{ __builtin_mul_overflow(a, b, &result) };
+				overflow |= over;
+				if constexpr(saturate)
+					result = over ? ((a < 0) == (b < 0) ? max : min) : result;
+			}
+			else
+			{
+				// a zero divisor or min / -1 divides by 1 instead, then the lane is fixed up
+				const bool zero{ b == 0 };
+				const bool over{ std::is_signed_v<T> && a == min && b == static_cast<T>(-1) };
+				const T quotient{ static_cast<T>(a / ((zero || over) ? T{ 1 } : b)) };
+				zeroDivisor |= zero;
+				overflow |= over;
+
+				if constexpr(saturate)
+					result = zero ? (a == 0 ? T{ 0 } : a > 0 ? max : min) : over ? max : quotient;
+				else
+					result = zero ? T{ 0 } : quotient;       // min / 1 is already the wrapped min / -1
+			}
+
+			out[i] = result;
+		}
+
+		blockFlags[first / checkedBlockSize] = static_cast<std::uint8_t>((overflow ? block_overflow : 0)
+										  | (zeroDivisor ? block_division_by_zero : 0));
+	}
+}
+
+// The operator chosen at runtime, dispatched once for the whole batch; returns the OR of all block flags
+template <typename Policy, typename T>
+std::uint8_t checkedBatch(Operation op, const T* x, const T* y, T* out, std::size_t count, std::uint8_t* blockFlags)
+{
+	visitOperation(op, [=](auto constant)
+	{
+		checkedBatch<Policy, decltype(constant)::value>(x, y, out, count, blockFlags);
+	});
+
+	std::uint8_t any{ 0 };
+	for(std::size_t block{ 0 }; block < checkedBlockCount(count); ++block)
+		any |= blockFlags[block];
+
+	return any;
+}
+
+#endif
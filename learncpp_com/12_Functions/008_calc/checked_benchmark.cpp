@@ -0,0 +1,127 @@
+// Checks checkedBatch() against the scalar checked.h functions and times the policies:
+// plain wrapping, Saturating in batches with block flags, and Reporting per element with a branch on its status.
+
+// Build: g++ -std=c++17 -O3 -march=native checked_benchmark.cpp     (the batch loops vectorize from -O3)
+
+#include "arithmetic.h"
+#include "checked.h"
+#include "checked_batch.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/timer.h"
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+template <typename Policy>
+typename Policy::template Result<int> checkedApply(Operation op, int x, int y)
+{
+	switch(op)
+	{
+		case Operation::add:        return checkedAdd<Policy>(x, y);
+		case Operation::subtract:   return checkedSubtract<Policy>(x, y);
+		case Operation::multiply:   return checkedMultiply<Policy>(x, y);
+		default:                    return checkedDivide<Policy>(x, y);
+	}
+}
+
+// Both batch policies must match the scalar functions element by element, and the block flags the reports
+template <typename Policy>
+bool check(Operation op, const std::vector<int>& x, const std::vector<int>& y)
+{
+	std::vector<int> out(x.size());
+	std::vector<std::uint8_t> flags(checkedBlockCount(x.size()));
+	checkedBatch<Policy>(op, x.data(), y.data(), out.data(), x.size(), flags.data());
+
+	std::vector<std::uint8_t> expected(flags.size());
+	for(std::size_t i{ 0 }; i < x.size(); ++i)
+	{
+		if(out[i] != checkedApply<Policy>(op, x[i], y[i]))
+			return false;
+
+		const CheckedStatus status{ checkedApply<Reporting>(op, x[i], y[i]).status };
+		if(status == CheckedStatus::overflow)
+			expected[i / checkedBlockSize] |= block_overflow;
+		if(status == CheckedStatus::division_by_zero)
+			expected[i / checkedBlockSize] |= block_division_by_zero;
+	}
+
+	return flags == expected;
+}
+
+int main()
+{
+	constexpr Operation operations[]{ Operation::add, Operation::subtract, Operation::multiply, Operation::divide };
+
+	std::mt19937 mt{ 11 };
+	std::uniform_int_distribution<int> any{ INT_MIN, INT_MAX };
+	std::uniform_int_distribution<int> small{ -2, 2 };
+	std::vector<int> x{ INT_MIN, INT_MIN, INT_MAX, 0, 5, -5 };
+	std::vector<int> y{ -1, 0, 1, 0, 0, 0 };
+	for(int i{ 0 }; i < 100'000; ++i)
+	{
+		// mostly quiet blocks with the odd extreme one
+		const bool wild{ (i / 256) % 7 == 0 };
+		x.push_back(wild ? any(mt) : any(mt) / 65536);
+		y.push_back(wild ? small(mt) : any(mt) / 65536);
+	}
+
+	for(const Operation op : operations)
+	{
+		if(!check<Wrapping>(op, x, y) || !check<Saturating>(op, x, y))
+		{
+			std::cout << "Mismatch for " << toSymbol(op) << '\n';
+			return 1;
+		}
+	}
+	std::cout << "Batches match the scalar policies.\n\n";
+
+	constexpr std::size_t count{ 1 << 20 };
+	constexpr int rounds{ 50 };
+	std::vector<int> a(count);
+	std::vector<int> b(count);
+	std::vector<int> out(count);
+	std::vector<std::uint8_t> flags(checkedBlockCount(count));
+	for(std::size_t i{ 0 }; i < count; ++i)
+	{
+		a[i] = any(mt) / 65536;
+		b[i] = any(mt) / 65536;
+	}
+
+	const double elements{ static_cast<double>(count) * rounds };
+	for(const Operation op : operations)
+	{
+		Timer timer{};
+		for(int round{ 0 }; round < rounds; ++round)
+			applyEach(op, a.data(), b.data(), out.data(), count);
+		const double wrapping{ timer.elapsed() };
+
+		timer.reset();
+		std::uint8_t seen{ 0 };
+		for(int round{ 0 }; round < rounds; ++round)
+			seen |= checkedBatch<Saturating>(op, a.data(), b.data(), out.data(), count, flags.data());
+		const double saturating{ timer.elapsed() };
+
+		timer.reset();
+		std::size_t failures{ 0 };
+		for(int round{ 0 }; round < rounds; ++round)
+		{
+			for(std::size_t i{ 0 }; i < count; ++i)
+			{
+				const Checked<int> result{ checkedApply<Reporting>(op, a[i], b[i]) };
+				if(!result.ok())
+					++failures;
+				out[i] = result.value;
+			}
+		}
+		const double reporting{ timer.elapsed() };
+
+		std::cout << toSymbol(op) << " (M ops/s)  wrapping: " << elements / wrapping / 1e6
+			  << "  saturating batch: " << elements / saturating / 1e6
+			  << "  reporting per element: " << elements / reporting / 1e6
+			  << "  (" << failures / rounds << " failures, flags " << int{ seen } << ")\n";
+	}
+
+	return 0;
+}
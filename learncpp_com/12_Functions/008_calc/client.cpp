@@ -0,0 +1,270 @@
+// Usage: client [--path /tmp/calc.sock] [--connections N] [--depth D] [--requests count]
+// Load generator for server.cpp: every connection keeps D requests in flight, sending a new one for each answer,
+// until it has sent its share of count requests. Prints p50/p99 latency and requests per second,
+// and checks every answer against the calculator computed locally.
+// Sockets are non-blocking and polled for reading and writing together, so a window deeper than the server
+// is willing to buffer still drains instead of deadlocking in a blocking write.
+
+// Build: g++ -std=c++17 -O2 -pthread client.cpp
+
+#include "checked.h"
+#include "protocol.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/timer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+struct ConnectionResult
+{
+	std::vector<double> latencies{};        // microseconds, one per answered request
+	std::uint64_t mismatches{ 0 };
+	bool failed{ false };
+};
+
+Request makeRequest(std::uint32_t id, std::mt19937& rng)
+{
+	constexpr char operators[]{ '+', '-', '*', '/' };
+	std::uniform_int_distribution<std::int32_t> value{ -100000, 100000 };
+
+	return { id, static_cast<std::uint8_t>(operators[rng() % 4]), {}, value(rng), value(rng) };
+}
+
+bool isExpected(const Request& request, const Response& response)
+{
+	Checked<int> expected{};
+	switch(request.op)
+	{
+		case '+':   expected = checkedAdd<Reporting>(request.x, request.y);       break;
+		case '-':   expected = checkedSubtract<Reporting>(request.x, request.y);  break;
+		case '*':   expected = checkedMultiply<Reporting>(request.x, request.y);  break;
+		case '/':   expected = checkedDivide<Reporting>(request.x, request.y);    break;
+	}
+
+	if(expected.status == CheckedStatus::division_by_zero)
+		return response.status == ResponseStatus::division_by_zero;
+
+	return response.result == expected.value
+	       && (response.status == ResponseStatus::overflow) == (expected.status == CheckedStatus::overflow);
+}
+
+int connectTo(const std::string& path)
+{
+	sockaddr_un address{};
+	if(path.size() >= sizeof(address.sun_path))
+		return -1;
+	address.sun_family = AF_UNIX;
+	std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+	const int fd{ ::socket(AF_UNIX, SOCK_STREAM, 0) };
+	if(fd >= 0 && ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		::close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+bool setNonBlocking(int fd)
+{
+	const int flags{ ::fcntl(fd, F_GETFL, 0) };
+	return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Runs one pipelined connection. Requests are answered in order, so the in-flight ones form a ring of depth slots.
+void runConnection(const std::string& path, std::size_t depth, std::uint64_t requests, std::uint32_t seed,
+		   ConnectionResult& result)
+{
+	const int fd{ connectTo(path) };
+	if(fd < 0)
+	{
+		result.failed = true;
+		return;
+	}
+
+	std::mt19937 rng{ seed };
+	std::vector<Request> inFlight(depth);
+	std::vector<Clock::time_point> sentAt(depth);
+	std::vector<RequestFrame> pending{};            // requests not yet written, the first partly sent
+	std::size_t pendingSent{ 0 };                   // bytes of pending already written
+	std::vector<char> input(64 * 1024);
+	std::size_t buffered{ 0 };
+	std::uint64_t sent{ 0 };
+	std::uint64_t received{ 0 };
+	result.latencies.reserve(requests);
+
+	// queue up to count new requests behind the unsent ones
+	auto queueRequests{ [&](std::uint64_t count)
+	{
+		const Clock::time_point now{ Clock::now() };
+		for(; count > 0 && sent < requests; --count, ++sent)
+		{
+			const Request request{ makeRequest(static_cast<std::uint32_t>(sent), rng) };
+			inFlight[sent % depth] = request;
+			sentAt[sent % depth] = now;
+			pending.push_back({ sizeof(Request), request });
+		}
+	} };
+
+	// write as many queued requests as the socket takes; false if the connection failed
+	auto flushRequests{ [&]
+	{
+		const std::size_t size{ pending.size() * sizeof(RequestFrame) };
+		while(pendingSent < size)
+		{
+			const ssize_t written{ ::write(fd, reinterpret_cast<const char*>(pending.data()) + pendingSent,
+						       size - pendingSent) };
+			if(written < 0 && errno == EINTR)
+				continue;
+			if(written < 0)
+				return errno == EAGAIN || errno == EWOULDBLOCK;
+
+			pendingSent += static_cast<std::size_t>(written);
+		}
+
+		pending.clear();
+		pendingSent = 0;
+		return true;
+	} };
+
+	queueRequests(depth);
+	bool ok{ setNonBlocking(fd) && flushRequests() };
+	while(ok && received < requests)
+	{
+		pollfd watch{ fd, static_cast<short>(POLLIN | (pending.empty() ? 0 : POLLOUT)), 0 };
+		if(::poll(&watch, 1, -1) < 0)
+		{
+			ok = errno == EINTR;
+			continue;
+		}
+
+		if((watch.revents & POLLOUT) && !flushRequests())
+		{
+			ok = false;
+			break;
+		}
+		if(!(watch.revents & (POLLIN | POLLHUP | POLLERR)))
+			continue;
+
+		const ssize_t got{ ::read(fd, input.data() + buffered, input.size() - buffered) };
+		if(got < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+			continue;
+		if(got <= 0)
+		{
+			ok = false;
+			break;
+		}
+		buffered += static_cast<std::size_t>(got);
+
+		const Clock::time_point now{ Clock::now() };
+		std::size_t offset{ 0 };
+		std::uint64_t answered{ 0 };
+		for(; buffered - offset >= sizeof(ResponseFrame); offset += sizeof(ResponseFrame), ++answered)
+		{
+			ResponseFrame frame{};
+			std::memcpy(&frame, input.data() + offset, sizeof(frame));
+			const std::size_t slot{ static_cast<std::size_t>(received % depth) };
+			if(frame.length != sizeof(Response) || frame.response.id != inFlight[slot].id)
+			{
+				ok = false;
+				break;
+			}
+
+			if(!isExpected(inFlight[slot], frame.response))
+				++result.mismatches;
+			result.latencies.push_back(std::chrono::duration<double, std::micro>(now - sentAt[slot]).count());
+			++received;
+		}
+
+		buffered -= offset;
+		std::memmove(input.data(), input.data() + offset, buffered);
+		queueRequests(answered);
+		ok = ok && flushRequests();
+	}
+
+	result.failed = !ok;
+	::close(fd);
+}
+
+double percentile(const std::vector<double>& sorted, double fraction)
+{
+	if(sorted.empty())
+		return 0.0;
+
+	return sorted[std::min(sorted.size() - 1, static_cast<std::size_t>(fraction * static_cast<double>(sorted.size())))];
+}
+
+int main(int argc, char* argv[])
+{
+	std::string path{ defaultSocketPath };
+	std::size_t connections{ 4 };
+	std::size_t depth{ 64 };
+	std::uint64_t requests{ 1'000'000 };
+	for(int i{ 1 }; i < argc; ++i)
+	{
+		const std::string arg{ argv[i] };
+		if(arg == "--path" && i + 1 < argc)
+			path = argv[++i];
+		else if(arg == "--connections" && i + 1 < argc)
+			connections = std::max<std::size_t>(1, std::stoul(argv[++i]));
+		else if(arg == "--depth" && i + 1 < argc)
+			depth = std::max<std::size_t>(1, std::stoul(argv[++i]));
+		else if(arg == "--requests" && i + 1 < argc)
+			requests = std::stoull(argv[++i]);
+	}
+
+	std::vector<ConnectionResult> results(connections);
+	std::vector<std::thread> threads{};
+	Timer timer{};
+	for(std::size_t i{ 0 }; i < connections; ++i)
+	{
+		const std::uint64_t share{ requests / connections + (i < requests % connections ? 1 : 0) };
+		threads.emplace_back(runConnection, std::cref(path), depth, share, static_cast<std::uint32_t>(i + 1),
+				     std::ref(results[i]));
+	}
+	for(std::thread& thread : threads)
+		thread.join();
+	const double seconds{ timer.elapsed() };
+
+	std::vector<double> latencies{};
+	std::uint64_t mismatches{ 0 };
+	std::size_t failed{ 0 };
+	for(const ConnectionResult& result : results)
+	{
+		latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+		mismatches += result.mismatches;
+		failed += result.failed ? 1 : 0;
+	}
+	std::sort(latencies.begin(), latencies.end());
+
+	std::cout << latencies.size() << " requests over " << connections << " connections, depth " << depth << '\n'
+		  << "p50 " << percentile(latencies, 0.50) << " us, p99 " << percentile(latencies, 0.99) << " us\n"
+		  << (seconds > 0 ? static_cast<double>(latencies.size()) / seconds : 0.0) << " requests/s\n";
+
+	if(mismatches > 0)
+		std::cout << mismatches << " wrong answers\n";
+	if(failed > 0)
+	{
+		std::cerr << failed << " connections failed\n";
+		return 1;
+	}
+
+	return mismatches > 0 ? 1 : 0;
+}
@@ -0,0 +1,164 @@
+#ifndef DISPATCH_H
+#define DISPATCH_H
+
+#include "arithmetic.h"
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Operator dispatch without std::function:
+// a constexpr table of plain function pointers for the runtime choice,
+// and templates that fix the operator at compile time so whole loops inline.
+
+using ArithmeticPointer = int (*)(int, int);
+
+inline constexpr ArithmeticPointer arithmeticTable[]{ &add, &subtract, &multiply, &divide };
+
+constexpr ArithmeticPointer getArithmeticPointer(Operation op)
+{
+	return arithmeticTable[static_cast<int>(op)];
+}
+
+template <Operation op>
+constexpr int apply(int x, int y)
+{
+	if constexpr(op == Operation::add)
+		return add(x, y);
+	else if constexpr(op == Operation::subtract)
+		return subtract(x, y);
+	else if constexpr(op == Operation::multiply)
+		return multiply(x, y);
+	else
+		return divide(x, y);
+}
+
+// Calls visitor(std::integral_constant<Operation, op>{}) with op known at compile time,
+// so one switch selects a fully specialized instance of whatever the visitor does
+template <typename Visitor>
+decltype(auto) visitOperation(Operation op, Visitor&& visitor)
+{
+	switch(op)
+	{
+		case Operation::add:        return visitor(std::integral_constant<Operation, Operation::add>{});
+		case Operation::subtract:   return visitor(std::integral_constant<Operation, Operation::subtract>{});
+		case Operation::multiply:   return visitor(std::integral_constant<Operation, Operation::multiply>{});
+		default:                    return visitor(std::integral_constant<Operation, Operation::divide>{});
+	}
+}
+
+// out[i] = op(x[i], y[i]), with the loop compiled once per operator
+template <Operation op>
+void applyEach(const int* x, const int* y, int* out, std::size_t count)
+{
+	for(std::size_t i{ 0 }; i < count; ++i)
+		out[i] = apply<op>(x[i], y[i]);
+}
+
+inline void applyEach(Operation op, const int* x, const int* y, int* out, std::size_t count)
+{
+	visitOperation(op, [=](auto constant)
+	{
+		applyEach<decltype(constant)::value>(x, y, out, count);
+	});
+}
+
+template <typename Signature, std::size_t Capacity = 32>
+class SmallFunction;
+
+// A copyable callable wrapper like std::function that never allocates:
+// the callable lives in an inline buffer and one that does not fit is a compile error.
+template <typename R, typename... Args, std::size_t Capacity>
+class SmallFunction<R(Args...), Capacity>
+{
+private:
+	struct Operations
+	{
+		R (*invoke)(void* target, Args&&... args);
+		void (*copy)(void* to, const void* from);
+		void (*destroy)(void* target);
+	};
+
+	template <typename F>
+	static R invokeTarget(void* target, Args&&... args)
+	{
+		return (*static_cast<F*>(target))(std::forward<Args>(args)...);
+	}
+
+	template <typename F>
+	static void copyTarget(void* to, const void* from)
+	{
+		::new(to) F(*static_cast<const F*>(from));
+	}
+
+	template <typename F>
+	static void destroyTarget(void* target)
+	{
+		static_cast<F*>(target)->~F();
+	}
+
+	template <typename F>
+	static inline constexpr Operations operationsFor{ &invokeTarget<F>, &copyTarget<F>, &destroyTarget<F> };
+
+	alignas(std::max_align_t) mutable unsigned char m_storage[Capacity]{};
+	const Operations* m_operations{ nullptr };
+
+	void reset()
+	{
+		if(m_operations)
+			m_operations->destroy(m_storage);
+		m_operations = nullptr;
+	}
+
+public:
+	SmallFunction() = default;
+
+	template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, SmallFunction>>>
+	SmallFunction(F&& callable)
+	{
+		using Target = std::decay_t<F>;
+		static_assert(sizeof(Target) <= Capacity, "Callable does not fit in SmallFunction, raise Capacity");
+		static_assert(alignof(Target) <= alignof(std::max_align_t), "Callable is over-aligned for SmallFunction");
+		static_assert(std::is_invocable_r_v<R, Target&, Args...>, "Callable has the wrong signature");
+
+		::new(static_cast<void*>(m_storage)) Target(std::forward<F>(callable));
+		m_operations = &operationsFor<Target>;
+	}
+
+	SmallFunction(const SmallFunction& other)
+		: m_operations{ other.m_operations }
+	{
+		if(m_operations)
+			m_operations->copy(m_storage, other.m_storage);
+	}
+
+	SmallFunction& operator=(const SmallFunction& other)
+	{
+		if(this != &other)
+		{
+			reset();
+			if(other.m_operations)
+				other.m_operations->copy(m_storage, other.m_storage);
+			m_operations = other.m_operations;
+		}
+
+		return *this;
+	}
+
+	~SmallFunction()
+	{
+		reset();
+	}
+
+	explicit operator bool() const
+	{
+		return m_operations != nullptr;
+	}
+
+	R operator()(Args... args) const
+	{
+		return m_operations->invoke(m_storage, std::forward<Args>(args)...);
+	}
+};
+
+#endif
@@ -0,0 +1,79 @@
+// Per-element std::function (001_calc_with_fcn_ptrs.cpp) against the dispatch layer in dispatch.h:
+// a function pointer from the constexpr table, SmallFunction, and the loop specialized per operator.
+
+// Build: g++ -std=c++17 -O2 dispatch_benchmark.cpp
+
+#include "arithmetic.h"
+#include "dispatch.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/timer.h"
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+constexpr std::size_t count{ 1 << 20 };
+constexpr int rounds{ 50 };
+
+static_assert(getArithmeticPointer(Operation::multiply) == &multiply);
+
+template <typename Callable>
+double timeLoop(const Callable& fcn, const std::vector<int>& x, const std::vector<int>& y, std::vector<int>& out)
+{
+	Timer timer{};
+	for(int round{ 0 }; round < rounds; ++round)
+	{
+		for(std::size_t i{ 0 }; i < count; ++i)
+			out[i] = fcn(x[i], y[i]);
+	}
+
+	return timer.elapsed();
+}
+
+int main()
+{
+	std::mt19937 mt{ 7 };
+	std::uniform_int_distribution<int> dist{ -100'000, 100'000 };
+	std::vector<int> x(count);
+	std::vector<int> y(count);
+	for(std::size_t i{ 0 }; i < count; ++i)
+	{
+		x[i] = dist(mt);
+		y[i] = dist(mt);
+	}
+
+	std::vector<int> expected(count);
+	std::vector<int> out(count);
+	const double elements{ static_cast<double>(count) * rounds };
+	constexpr Operation operations[]{ Operation::add, Operation::subtract, Operation::multiply, Operation::divide };
+	for(const Operation op : operations)
+	{
+		const std::function<int(int, int)> function{ getArithmeticPointer(op) };
+		const double functionSeconds{ timeLoop(function, x, y, expected) };
+
+		// volatile keeps the compiler from folding the table lookup into a direct call
+		volatile Operation hidden{ op };
+		const ArithmeticPointer pointer{ getArithmeticPointer(hidden) };
+		const double pointerSeconds{ timeLoop(pointer, x, y, out) };
+		bool match{ out == expected };
+
+		const int offset{ 0 };
+		const SmallFunction<int(int, int)> small{ [pointer, offset](int a, int b) { return pointer(a, b) + offset; } };
+		const double smallSeconds{ timeLoop(small, x, y, out) };
+		match = match && out == expected;
+
+		Timer timer{};
+		for(int round{ 0 }; round < rounds; ++round)
+			applyEach(hidden, x.data(), y.data(), out.data(), count);
+		const double specializedSeconds{ timer.elapsed() };
+		match = match && out == expected;
+
+		std::cout << toSymbol(op) << " (M ops/s)  std::function: " << elements / functionSeconds / 1e6
+			  << "  pointer: " << elements / pointerSeconds / 1e6
+			  << "  SmallFunction: " << elements / smallSeconds / 1e6
+			  << "  specialized loop: " << elements / specializedSeconds / 1e6
+			  << (match ? "" : "  RESULTS DIFFER") << '\n';
+	}
+
+	return 0;
+}
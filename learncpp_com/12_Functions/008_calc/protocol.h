@@ -0,0 +1,53 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <cstdint>
+
+// Wire format of the calculator service (server.cpp, client.cpp) on a Unix domain socket.
+// Every message is a uint32 payload length followed by the payload. The socket is local,
+// so integers are in host byte order. A client may send any number of requests without waiting;
+// responses come back in request order and carry the request's id.
+
+inline constexpr char defaultSocketPath[]{ "/tmp/calc.sock" };
+
+struct Request
+{
+	std::uint32_t id;
+	std::uint8_t op;                // '+', '-', '*' or '/'
+	std::uint8_t reserved[3];
+	std::int32_t x;
+	std::int32_t y;
+};
+
+enum class ResponseStatus : std::uint8_t
+{
+	ok,
+	overflow,                       // result holds the wrapped value
+	division_by_zero,
+	bad_operator,
+};
+
+struct Response
+{
+	std::uint32_t id;
+	ResponseStatus status;
+	std::uint8_t reserved[3];
+	std::int32_t result;
+};
+
+struct RequestFrame
+{
+	std::uint32_t length;           // sizeof(Request)
+	Request request;
+};
+
+struct ResponseFrame
+{
+	std::uint32_t length;           // sizeof(Response)
+	Response response;
+};
+
+static_assert(sizeof(Request) == 16 && sizeof(RequestFrame) == 20);
+static_assert(sizeof(Response) == 12 && sizeof(ResponseFrame) == 16);
+
+#endif
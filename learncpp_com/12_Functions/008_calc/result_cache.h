@@ -0,0 +1,226 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Bounded LRU cache for calculator results, split into independently locked shards
+// so concurrent callers rarely contend. Each shard is a recency list plus a hash index;
+// once a shard is full the least recently used entry's list and index nodes are reused for the
+// new key, so a warm cache does not allocate.
+// The cache is a template parameter of CachedEvaluator: NoCache compiles the lookup away entirely.
+
+// One calculation: operands of any value type (int, std::int64_t, BigInt, ...) and the operator,
+// either an Operation or the operator character the calculators read
+template <typename T, typename Op>
+struct CalcKey
+{
+	T x{};
+	T y{};
+	Op op{};
+
+	friend bool operator==(const CalcKey& a, const CalcKey& b) { return a.x == b.x && a.y == b.y && a.op == b.op; }
+};
+
+template <typename T, typename Op>
+struct CalcKeyHash
+{
+	static std::uint64_t mix(std::uint64_t h)
+	{
+		h ^= h >> 29;
+		h *= 0xBF58'476D'1CE4'E5B9;
+		return h ^ (h >> 32);
+	}
+
+	std::size_t operator()(const CalcKey<T, Op>& key) const
+	{
+		// each field is mixed in on its own, so no two fields can trade values and collide;
+		// the top bits pick the shard, the whole value the bucket
+		const std::hash<T> hashValue{};
+		std::uint64_t h{ mix(static_cast<std::uint64_t>(hashValue(key.x)) * 0x9E37'79B9'7F4A'7C15) };
+		h = mix(h ^ static_cast<std::uint64_t>(hashValue(key.y)) * 0xC2B2'AE3D'27D4'EB4F);
+		h = mix(h ^ (static_cast<std::uint64_t>(key.op) + 1) * 0x1656'67B1'9E37'79F9);
+		return static_cast<std::size_t>(h);
+	}
+};
+
+struct CacheStats
+{
+	std::uint64_t hits{};
+	std::uint64_t misses{};
+	std::uint64_t evictions{};
+	std::uint64_t entries{};
+};
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class ShardedLruCache
+{
+private:
+	using Entry = std::pair<Key, Value>;
+	using Recency = std::list<Entry>;                   // most recent first
+
+	// aligned so two shards' locks and counters never share a cache line
+	struct alignas(64) Shard
+	{
+		std::mutex mutex{};
+		Recency recency{};
+		std::unordered_map<Key, typename Recency::iterator, Hash> index{};
+		std::uint64_t hits{};
+		std::uint64_t misses{};
+		std::uint64_t evictions{};
+	};
+
+	std::vector<std::unique_ptr<Shard>> m_shards{};
+	std::size_t m_shardCapacity{};
+	Hash m_hash{};
+
+	Shard& shardFor(std::size_t hash) const
+	{
+		return *m_shards[(hash >> 48) % m_shards.size()];
+	}
+
+public:
+	// capacity is split evenly over the shards; every shard holds at least one entry
+	explicit ShardedLruCache(std::size_t capacity, std::size_t shardCount = 16)
+		: m_shardCapacity{ std::max<std::size_t>(1, capacity / std::max<std::size_t>(1, shardCount)) }
+	{
+		for(std::size_t i{ 0 }; i < std::max<std::size_t>(1, shardCount); ++i)
+		{
+			m_shards.push_back(std::make_unique<Shard>());
+			m_shards.back()->index.reserve(m_shardCapacity);
+		}
+	}
+
+	bool lookup(const Key& key, Value& value)
+	{
+		const std::size_t hash{ m_hash(key) };
+		Shard& shard{ shardFor(hash) };
+		std::lock_guard lock{ shard.mutex };
+
+		const auto found{ shard.index.find(key) };
+		if(found == shard.index.end())
+		{
+			++shard.misses;
+			return false;
+		}
+
+		++shard.hits;
+		shard.recency.splice(shard.recency.begin(), shard.recency, found->second);
+		value = found->second->second;
+		return true;
+	}
+
+	void insert(const Key& key, const Value& value)
+	{
+		const std::size_t hash{ m_hash(key) };
+		Shard& shard{ shardFor(hash) };
+		std::lock_guard lock{ shard.mutex };
+
+		// another caller may have computed the same key in the meantime
+		const auto found{ shard.index.find(key) };
+		if(found != shard.index.end())
+		{
+			found->second->second = value;
+			shard.recency.splice(shard.recency.begin(), shard.recency, found->second);
+			return;
+		}
+
+		if(shard.index.size() < m_shardCapacity)
+		{
+			shard.recency.emplace_front(key, value);
+			shard.index.emplace(key, shard.recency.begin());
+			return;
+		}
+
+		// full: recycle the least recently used entry, both its list node and its index node
+		++shard.evictions;
+		const auto oldest{ std::prev(shard.recency.end()) };
+		auto node{ shard.index.extract(oldest->first) };
+		node.key() = key;
+		oldest->first = key;
+		oldest->second = value;
+		shard.recency.splice(shard.recency.begin(), shard.recency, oldest);
+		shard.index.insert(std::move(node));
+	}
+
+	// The cached value, or compute() stored and returned; compute runs without any lock held
+	template <typename Compute>
+	Value getOrCompute(const Key& key, Compute&& compute)
+	{
+		Value value{};
+		if(lookup(key, value))
+			return value;
+
+		value = compute();
+		insert(key, value);
+		return value;
+	}
+
+	CacheStats stats() const
+	{
+		CacheStats total{};
+		for(const auto& shard : m_shards)
+		{
+			std::lock_guard lock{ shard->mutex };
+			total.hits += shard->hits;
+			total.misses += shard->misses;
+			total.evictions += shard->evictions;
+			total.entries += shard->index.size();
+		}
+
+		return total;
+	}
+
+	std::size_t capacity() const { return m_shardCapacity * m_shards.size(); }
+};
+
+// Stands in for ShardedLruCache when caching is off; every call goes straight to compute()
+struct NoCache
+{
+	NoCache() = default;
+	explicit NoCache(std::size_t, std::size_t = 0) {}
+
+	template <typename Key, typename Compute>
+	auto getOrCompute(const Key&, Compute&& compute) { return compute(); }
+
+	CacheStats stats() const { return {}; }
+};
+
+// The cache for a calculator with operands of type T and results of type Value,
+// or NoCache when enabled is false, so a calculator can switch caching at compile time
+template <bool enabled, typename T, typename Value, typename Op>
+using CalcCache = std::conditional_t<enabled, ShardedLruCache<CalcKey<T, Op>, Value, CalcKeyHash<T, Op>>, NoCache>;
+
+// Evaluates (x, op, y) through evaluate(x, op, y), consulting Cache first.
+// With Cache = NoCache this is exactly a call to evaluate.
+template <typename Cache, typename Evaluate>
+class CachedEvaluator
+{
+private:
+	Cache& m_cache;
+	Evaluate m_evaluate;
+
+public:
+	CachedEvaluator(Cache& cache, Evaluate evaluate)
+		: m_cache{ cache }, m_evaluate{ std::move(evaluate) }
+	{
+	}
+
+	template <typename T, typename Op>
+	auto operator()(const T& x, Op op, const T& y)
+	{
+		return m_cache.getOrCompute(CalcKey<T, Op>{ x, y, op }, [&] { return m_evaluate(x, op, y); });
+	}
+};
+
+#endif
@@ -0,0 +1,299 @@
+// Usage: server [socket path=/tmp/calc.sock]
+// Serves the calculator of 001_calc_with_fcn_ptrs.cpp over a Unix domain socket (protocol.h).
+// One thread, one epoll set: every readable connection has all of its complete requests answered at once,
+// and the answers are queued and sent with a single writev.
+// A client that shuts down its write side still gets every answer: the connection closes once its output drains.
+// Each readable event reads at most maxReadPerEvent bytes, so one busy client can not starve the others,
+// and a client that does not read its answers stops being read once highWater bytes are queued for it.
+
+// Build: g++ -std=c++17 -O2 server.cpp
+
+#include "checked.h"
+#include "protocol.h"
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Responses are queued in chunks of this many bytes; writev sends up to maxChunksPerWrite chunks per call
+constexpr std::size_t chunkSize{ 64 * 1024 };
+constexpr std::size_t maxChunksPerWrite{ 64 };
+
+constexpr std::size_t readSize{ 64 * 1024 };
+constexpr std::size_t maxReadPerEvent{ 4 * readSize };
+constexpr int maxEvents{ 256 };
+
+// Reading a connection pauses while more than highWater bytes of answers wait for it, and resumes below lowWater
+constexpr std::size_t highWater{ 4 * 1024 * 1024 };
+constexpr std::size_t lowWater{ highWater / 4 };
+
+struct Connection
+{
+	int fd{ -1 };
+	std::vector<char> input{};                      // bytes received and not yet parsed
+	std::vector<std::vector<char>> output{};        // queued response chunks, the first partly sent
+	std::size_t sent{ 0 };                          // bytes of output.front() already written
+	std::size_t queued{ 0 };                        // bytes of output not yet written
+	bool readClosed{ false };                       // the client shut down its write side
+	bool readPaused{ false };                       // too much output queued to keep reading
+	std::uint32_t events{ 0 };                      // the epoll events registered for fd
+};
+
+Response answer(const Request& request)
+{
+	Checked<int> result{};
+	switch(request.op)
+	{
+		case '+':   result = checkedAdd<Reporting>(request.x, request.y);       break;
+		case '-':   result = checkedSubtract<Reporting>(request.x, request.y);  break;
+		case '*':   result = checkedMultiply<Reporting>(request.x, request.y);  break;
+		case '/':   result = checkedDivide<Reporting>(request.x, request.y);    break;
+		default:    return { request.id, ResponseStatus::bad_operator, {}, 0 };
+	}
+
+	const ResponseStatus status{ result.status == CheckedStatus::ok       ? ResponseStatus::ok
+				     : result.status == CheckedStatus::overflow ? ResponseStatus::overflow
+										: ResponseStatus::division_by_zero };
+	return { request.id, status, {}, result.value };
+}
+
+void queueResponse(Connection& connection, const Response& response)
+{
+	if(connection.output.empty() || connection.output.back().size() + sizeof(ResponseFrame) > chunkSize)
+	{
+		connection.output.emplace_back();
+		connection.output.back().reserve(chunkSize);
+	}
+
+	const ResponseFrame frame{ sizeof(Response), response };
+	const auto* bytes{ reinterpret_cast<const char*>(&frame) };
+	connection.output.back().insert(connection.output.back().end(), bytes, bytes + sizeof(frame));
+	connection.queued += sizeof(frame);
+}
+
+// Answers every complete request in the input buffer; false on a malformed frame
+bool handleInput(Connection& connection)
+{
+	std::size_t offset{ 0 };
+	while(connection.input.size() - offset >= sizeof(std::uint32_t))
+	{
+		std::uint32_t length{};
+		std::memcpy(&length, connection.input.data() + offset, sizeof(length));
+		if(length != sizeof(Request))
+			return false;
+		if(connection.input.size() - offset < sizeof(RequestFrame))
+			break;
+
+		Request request{};
+		std::memcpy(&request, connection.input.data() + offset + sizeof(length), sizeof(request));
+		queueResponse(connection, answer(request));
+		offset += sizeof(RequestFrame);
+	}
+
+	connection.input.erase(connection.input.begin(), connection.input.begin() + static_cast<std::ptrdiff_t>(offset));
+	return true;
+}
+
+// Writes as much queued output as the socket takes; false if the connection failed
+bool flushOutput(Connection& connection)
+{
+	while(!connection.output.empty())
+	{
+		iovec chunks[maxChunksPerWrite]{};
+		std::size_t count{ 0 };
+		for(; count < connection.output.size() && count < maxChunksPerWrite; ++count)
+		{
+			const std::size_t skip{ count == 0 ? connection.sent : 0 };
+			chunks[count].iov_base = connection.output[count].data() + skip;
+			chunks[count].iov_len = connection.output[count].size() - skip;
+		}
+
+		const ssize_t written{ ::writev(connection.fd, chunks, static_cast<int>(count)) };
+		if(written < 0)
+			return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+
+		// drop the chunks that went out completely
+		auto remaining{ static_cast<std::size_t>(written) };
+		connection.queued -= remaining;
+		while(remaining > 0)
+		{
+			const std::size_t left{ connection.output.front().size() - connection.sent };
+			if(remaining < left)
+			{
+				connection.sent += remaining;
+				break;
+			}
+
+			remaining -= left;
+			connection.sent = 0;
+			connection.output.erase(connection.output.begin());
+		}
+
+		if(static_cast<std::size_t>(written) == 0)
+			return true;
+	}
+
+	return true;
+}
+
+bool setNonBlocking(int fd)
+{
+	const int flags{ ::fcntl(fd, F_GETFL, 0) };
+	return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+int listenOn(const std::string& path)
+{
+	sockaddr_un address{};
+	if(path.size() >= sizeof(address.sun_path))
+	{
+		std::cerr << "Socket path too long\n";
+		return -1;
+	}
+	address.sun_family = AF_UNIX;
+	std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+	const int fd{ ::socket(AF_UNIX, SOCK_STREAM, 0) };
+	::unlink(path.c_str());
+	if(fd < 0 || ::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+	   || ::listen(fd, SOMAXCONN) != 0 || !setNonBlocking(fd))
+	{
+		std::cerr << "Can not listen on " << path << ": " << std::strerror(errno) << '\n';
+		if(fd >= 0)
+			::close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+int main(int argc, char* argv[])
+{
+	const std::string path{ argc > 1 ? argv[1] : defaultSocketPath };
+	std::signal(SIGPIPE, SIG_IGN);          // a client that hangs up shows as a write error instead
+
+	const int listener{ listenOn(path) };
+	const int epoll{ ::epoll_create1(0) };
+	if(listener < 0 || epoll < 0)
+	{
+		return 1;
+	}
+
+	epoll_event event{};
+	event.events = EPOLLIN;
+	event.data.fd = listener;
+	::epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &event);
+	std::cerr << "Listening on " << path << '\n';
+
+	std::unordered_map<int, std::unique_ptr<Connection>> connections{};
+	std::vector<char> buffer(readSize);
+	epoll_event events[maxEvents]{};
+
+	auto closeConnection{ [&](int fd)
+	{
+		::epoll_ctl(epoll, EPOLL_CTL_DEL, fd, nullptr);
+		::close(fd);
+		connections.erase(fd);
+	} };
+
+	while(true)
+	{
+		const int ready{ ::epoll_wait(epoll, events, maxEvents, -1) };
+		if(ready < 0 && errno != EINTR)
+		{
+			std::cerr << "epoll_wait: " << std::strerror(errno) << '\n';
+			return 1;
+		}
+
+		for(int i{ 0 }; i < ready; ++i)
+		{
+			const int fd{ events[i].data.fd };
+			if(fd == listener)
+			{
+				int client{};
+				while((client = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK)) >= 0)
+				{
+					auto connection{ std::make_unique<Connection>() };
+					connection->fd = client;
+					connection->events = EPOLLIN | EPOLLRDHUP;
+					epoll_event clientEvent{};
+					clientEvent.events = connection->events;
+					clientEvent.data.fd = client;
+					::epoll_ctl(epoll, EPOLL_CTL_ADD, client, &clientEvent);
+					connections[client] = std::move(connection);
+				}
+				continue;
+			}
+
+			const auto found{ connections.find(fd) };
+			if(found == connections.end())
+				continue;
+			Connection& connection{ *found->second };
+
+			bool alive{ true };
+			if(!connection.readClosed && !connection.readPaused
+			   && (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)))
+			{
+				// read up to maxReadPerEvent bytes, then answer everything that arrived in one go;
+				// epoll reports whatever is left again on the next round
+				std::size_t total{ 0 };
+				while(total < maxReadPerEvent)
+				{
+					const ssize_t got{ ::read(fd, buffer.data(), buffer.size()) };
+					if(got > 0)
+					{
+						connection.input.insert(connection.input.end(), buffer.data(), buffer.data() + got);
+						total += static_cast<std::size_t>(got);
+						continue;
+					}
+					if(got == 0)
+						connection.readClosed = true;
+					else if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+						alive = false;
+					if(got == 0 || errno != EINTR)
+						break;
+				}
+
+				alive = handleInput(connection) && alive;
+			}
+
+			alive = flushOutput(connection) && alive;
+			if(!alive || (connection.readClosed && connection.output.empty()))
+			{
+				closeConnection(fd);
+				continue;
+			}
+
+			if(connection.queued > highWater)
+				connection.readPaused = true;
+			else if(connection.queued < lowWater)
+				connection.readPaused = false;
+
+			// read while the client may send and its answers are not piling up,
+			// and only ask for EPOLLOUT while there is something the socket did not take
+			const std::uint32_t wanted{ (connection.readClosed || connection.readPaused ? 0u : EPOLLIN | EPOLLRDHUP)
+						    | (connection.output.empty() ? 0u : EPOLLOUT) };
+			if(wanted != connection.events)
+			{
+				epoll_event clientEvent{};
+				clientEvent.events = wanted;
+				clientEvent.data.fd = fd;
+				::epoll_ctl(epoll, EPOLL_CTL_MOD, fd, &clientEvent);
+				connection.events = wanted;
+			}
+		}
+	}
+}
@@ -0,0 +1,269 @@
+#include "stream.h"
+#include "arithmetic.h"
+#include "checked.h"
+#include "result_cache.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Bytes read per block
+constexpr std::size_t blockSize{ 4 << 20 };
+
+// Blocks smaller than this per thread are not worth splitting
+constexpr std::size_t minimumPartSize{ 64 * 1024 };
+
+constexpr std::size_t outputFlushSize{ 1 << 20 };
+
+const char* skipSpaces(const char* p, const char* end)
+{
+	while(p < end && (*p == ' ' || *p == '\t'))
+		++p;
+
+	return p;
+}
+
+template <typename T>
+bool parseNumber(const char*& p, const char* end, T& value)
+{
+	const auto [ptr, ec]{ std::from_chars(p, end, value) };
+	p = ptr;
+
+	return ec == std::errc{};
+}
+
+template <typename T>
+void appendNumber(std::string& output, T value)
+{
+	char digits[32]{};
+	output.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr);
+	output.push_back('\n');
+}
+
+// The answer to an integer line whose operator is valid. It has no side effects, so it can sit behind the result cache.
+Checked<int> evaluateInteger(int x, char op, int y)
+{
+	if((op == '/' || op == '%') && y == 0)
+		return { 0, CheckedStatus::division_by_zero };
+
+	switch(op)
+	{
+		case '+':   return { add(x, y) };
+		case '-':   return { subtract(x, y) };
+		case '*':   return { multiply(x, y) };
+		case '/':   return { divide(x, y) };
+		case '%':   return { static_cast<int>(static_cast<std::int64_t>(x) % y) };
+	}
+
+	return {};
+}
+
+// Appends the answer for one line; false if the line is malformed. Integer lines are answered through evaluate.
+template <typename T, typename Evaluator>
+bool calculateLine(const char* p, const char* end, std::string& output, StreamStats& stats, Evaluator& evaluate)
+{
+	T x{};
+	T y{};
+	if(!parseNumber(p, end, x))
+		return false;
+
+	p = skipSpaces(p, end);
+	if(p == end)
+		return false;
+	const char op{ *p++ };
+
+	p = skipSpaces(p, end);
+	if(!parseNumber(p, end, y) || skipSpaces(p, end) != end)
+		return false;
+
+	if constexpr(std::is_same_v<T, int>)
+	{
+		if(op != '+' && op != '-' && op != '*' && op != '/' && op != '%')
+			return false;
+
+		const Checked<int> answer{ evaluate(x, op, y) };
+		if(answer.status == CheckedStatus::division_by_zero)
+		{
+			++stats.divisionByZero;
+			output.append("division by zero\n");
+		}
+		else
+		{
+			appendNumber(output, answer.value);
+		}
+
+		return true;
+	}
+	else
+	{
+		switch(op)
+		{
+			case '+':   appendNumber(output, x + y);    return true;
+			case '-':   appendNumber(output, x - y);    return true;
+			case '*':   appendNumber(output, x * y);    return true;
+			case '/':   appendNumber(output, x / y);    return true;
+		}
+	}
+
+	return false;
+}
+
+struct Part
+{
+	const char* begin{};
+	const char* end{};
+	std::string output{};
+	StreamStats stats{};
+};
+
+template <typename Cache>
+void calculatePart(Part& part, StreamNumbers numbers, Cache& cache)
+{
+	CachedEvaluator evaluate{ cache, &evaluateInteger };
+	const char* begin{ part.begin };
+	while(begin < part.end)
+	{
+		const char* lineEnd{ static_cast<const char*>(std::memchr(begin, '\n', static_cast<std::size_t>(part.end - begin))) };
+		if(!lineEnd)
+			lineEnd = part.end;
+
+		const char* textEnd{ lineEnd };
+		while(textEnd > begin && (textEnd[-1] == '\r' || textEnd[-1] == ' ' || textEnd[-1] == '\t'))
+			--textEnd;
+		const char* text{ skipSpaces(begin, textEnd) };
+
+		if(text < textEnd)
+		{
+			++part.stats.lines;
+			const bool valid{ numbers == StreamNumbers::integer
+					  ? calculateLine<int>(text, textEnd, part.output, part.stats, evaluate)
+					  : calculateLine<double>(text, textEnd, part.output, part.stats, evaluate) };
+			if(!valid)
+			{
+				++part.stats.invalid;
+				part.output.append("invalid\n");
+			}
+		}
+
+		begin = lineEnd + 1;
+	}
+}
+
+// Splits [begin, end) into up to parts.size() pieces that each end after a newline
+std::size_t splitBlock(const char* begin, const char* end, std::vector<Part>& parts)
+{
+	const auto size{ static_cast<std::size_t>(end - begin) };
+	const std::size_t count{ std::max<std::size_t>(1, std::min(parts.size(), size / minimumPartSize)) };
+
+	const char* first{ begin };
+	for(std::size_t i{ 0 }; i < count; ++i)
+	{
+		const char* last{ i + 1 == count ? end : std::max(first, begin + size / count * (i + 1)) };
+		const char* newline{ static_cast<const char*>(std::memchr(last, '\n', static_cast<std::size_t>(end - last))) };
+		if(i + 1 < count)
+			last = newline ? newline + 1 : end;
+
+		parts[i].begin = first;
+		parts[i].end = last;
+		first = last;
+	}
+
+	return count;
+}
+
+template <typename Cache>
+StreamStats calculateStreamWith(std::FILE* in, std::FILE* out, StreamNumbers numbers, std::size_t threads, Cache& cache)
+{
+	StreamStats stats{};
+	std::vector<char> buffer(blockSize);
+	std::vector<Part> parts(std::max<std::size_t>(1, threads));
+	for(Part& part : parts)
+		part.output.reserve(outputFlushSize + 64);
+
+	std::string& output{ parts[0].output };
+	std::vector<std::thread> workers{};
+
+	std::size_t carried{ 0 };       // bytes of an unfinished line kept from the previous block
+	while(true)
+	{
+		if(carried == buffer.size())
+			buffer.resize(buffer.size() * 2);       // a single line longer than the whole buffer
+
+		const std::size_t read{ std::fread(buffer.data() + carried, 1, buffer.size() - carried, in) };
+		const std::size_t filled{ carried + read };
+		const bool atEnd{ read == 0 };
+		if(filled == 0)
+			break;
+
+		// everything up to the last newline is complete; at end of input the rest is a final line
+		const char* begin{ buffer.data() };
+		const char* end{ begin + filled };
+		const char* complete{ end };
+		if(!atEnd)
+		{
+			while(complete > begin && complete[-1] != '\n')
+				--complete;
+		}
+
+		const std::size_t count{ splitBlock(begin, complete, parts) };
+		workers.clear();
+		for(std::size_t i{ 1 }; i < count; ++i)
+			workers.emplace_back(calculatePart<Cache>, std::ref(parts[i]), numbers, std::ref(cache));
+		calculatePart(parts[0], numbers, cache);
+
+		// the first part's buffer is the running output; later parts are appended in order
+		for(std::size_t i{ 0 }; i < count; ++i)
+		{
+			if(i > 0)
+			{
+				workers[i - 1].join();
+				std::fwrite(parts[i].output.data(), 1, parts[i].output.size(), out);
+				parts[i].output.clear();
+			}
+			else if(output.size() >= outputFlushSize || count > 1)
+			{
+				std::fwrite(output.data(), 1, output.size(), out);
+				output.clear();
+			}
+
+			stats.lines += parts[i].stats.lines;
+			stats.invalid += parts[i].stats.invalid;
+			stats.divisionByZero += parts[i].stats.divisionByZero;
+			parts[i].stats = {};
+		}
+
+		carried = static_cast<std::size_t>(end - complete);
+		std::memmove(buffer.data(), complete, carried);
+		if(atEnd)
+			break;
+	}
+
+	std::fwrite(output.data(), 1, output.size(), out);
+	std::fflush(out);
+
+	return stats;
+}
+
+StreamStats calculateStream(std::FILE* in, std::FILE* out, StreamNumbers numbers, std::size_t threads,
+			    std::size_t cacheCapacity)
+{
+	if(cacheCapacity == 0)
+	{
+		NoCache noCache{};
+		return calculateStreamWith(in, out, numbers, threads, noCache);
+	}
+
+	CalcCache<true, int, Checked<int>, char> cache{ cacheCapacity };
+	StreamStats stats{ calculateStreamWith(in, out, numbers, threads, cache) };
+	stats.cacheHits = cache.stats().hits;
+
+	return stats;
+}
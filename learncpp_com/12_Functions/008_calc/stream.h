@@ -0,0 +1,35 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+	// Non-interactive mode shared by the calculators: every input line is "a op b"
+	// (spaces optional) and produces one output line. Blank lines are skipped.
+	//   integer:  int operands and + - * / % as in 000_switch_calc.cpp / 001_calc_with_fcn_ptrs.cpp,
+	//             with the wrapping results of arithmetic.h; a zero divisor prints "division by zero"
+	//   floating: double operands and + - * / as in 002_double_calc.cpp, printed in shortest round-trip form
+	// Malformed lines print "invalid".
+	enum class StreamNumbers
+	{
+		integer,
+		floating,
+	};
+
+	struct StreamStats
+	{
+		std::uint64_t lines{};
+		std::uint64_t invalid{};
+		std::uint64_t divisionByZero{};
+		std::uint64_t cacheHits{};
+	};
+
+	// With threads > 1 every block of input is split at line boundaries and the parts are computed
+	// concurrently; output order always matches input.
+	// With cacheCapacity > 0 integer answers go through a result cache (result_cache.h) of that many entries,
+	// shared by all threads; it pays off when the same lines repeat.
+	StreamStats calculateStream(std::FILE* in, std::FILE* out, StreamNumbers numbers, std::size_t threads = 1,
+				    std::size_t cacheCapacity = 0);
+
+#endif
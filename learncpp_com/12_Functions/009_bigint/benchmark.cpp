@@ -0,0 +1,68 @@
+// Times BigInt multiplication, division and decimal conversion from 100 up to 1,000,000 digit operands.
+// Each size checks (x * y) / y == x and that the decimal string round-trips.
+
+// Build: g++ -std=c++17 -O2 benchmark.cpp bigint.cpp
+
+#include "bigint.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/timer.h"
+#include <iostream>
+#include <random>
+#include <string>
+
+std::string randomDigits(std::size_t count, std::mt19937_64& mt)
+{
+	std::string digits(count, '0');
+	digits[0] = static_cast<char>('1' + mt() % 9);
+	for(std::size_t i{ 1 }; i < count; ++i)
+		digits[i] = static_cast<char>('0' + mt() % 10);
+
+	return digits;
+}
+
+int main()
+{
+	std::mt19937_64 mt{ 2024 };
+	std::cout << "digits      multiply(s)  divide(s)    toString(s)  fromString(s)\n";
+
+	for(std::size_t digits{ 100 }; digits <= 1'000'000; digits *= 10)
+	{
+		const std::string text{ randomDigits(digits, mt) };
+		BigInt x{};
+		BigInt y{};
+		BigInt::fromString(text, x);
+		BigInt::fromString(randomDigits(digits, mt), y);
+
+		// small sizes are repeated so the timer has something to measure
+		const int repeats{ digits <= 10'000 ? 100 : 1 };
+
+		Timer timer{};
+		BigInt product{};
+		for(int i{ 0 }; i < repeats; ++i)
+			product = x * y;
+		const double multiplySeconds{ timer.elapsed() / repeats };
+
+		timer.reset();
+		BigInt quotient{};
+		for(int i{ 0 }; i < repeats; ++i)
+			quotient = product / y;
+		const double divideSeconds{ timer.elapsed() / repeats };
+
+		timer.reset();
+		std::string decimal{};
+		for(int i{ 0 }; i < repeats; ++i)
+			decimal = x.toString();
+		const double toStringSeconds{ timer.elapsed() / repeats };
+
+		timer.reset();
+		BigInt parsed{};
+		for(int i{ 0 }; i < repeats; ++i)
+			BigInt::fromString(decimal, parsed);
+		const double fromStringSeconds{ timer.elapsed() / repeats };
+
+		const bool ok{ quotient == x && decimal == text && parsed == x };
+		std::cout << digits << (digits < 1'000'000 ? "\t    " : "     ") << multiplySeconds << "\t " << divideSeconds << "\t      "
+			  << toStringSeconds << "\t   " << fromStringSeconds << (ok ? "" : "   WRONG RESULT") << '\n';
+	}
+
+	return 0;
+}
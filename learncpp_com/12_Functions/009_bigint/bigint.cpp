@@ -0,0 +1,693 @@
+#include "bigint.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using Limbs = std::vector<std::uint64_t>;
+using uint128 = unsigned __int128;
+
+// Below these sizes (in limbs) the simple quadratic algorithms win
+constexpr std::size_t karatsubaThreshold{ 32 };
+constexpr std::size_t newtonThreshold{ 64 };
+constexpr std::size_t decimalThreshold{ 32 };
+
+constexpr std::uint64_t tenTo19{ 10'000'000'000'000'000'000u };
+constexpr std::size_t digitsPerLimb{ 19 };
+
+// ---- magnitudes: little-endian limb spans --------------------------------------------------------
+
+void trim(Limbs& x)
+{
+	while(!x.empty() && x.back() == 0)
+		x.pop_back();
+}
+
+int compareMagnitude(const Limbs& x, const Limbs& y)
+{
+	if(x.size() != y.size())
+		return x.size() < y.size() ? -1 : 1;
+
+	for(std::size_t i{ x.size() }; i-- > 0;)
+	{
+		if(x[i] != y[i])
+			return x[i] < y[i] ? -1 : 1;
+	}
+
+	return 0;
+}
+
+// out[0, n) += y[0, yn) with yn <= n; returns the carry out of out[n - 1]
+std::uint64_t addInto(std::uint64_t* out, std::size_t n, const std::uint64_t* y, std::size_t yn)
+{
+	std::uint64_t carry{ 0 };
+	std::size_t i{ 0 };
+	for(; i < yn; ++i)
+	{
+		const uint128 sum{ static_cast<uint128>(out[i]) + y[i] + carry };
+		out[i] = static_cast<std::uint64_t>(sum);
+		carry = static_cast<std::uint64_t>(sum >> 64);
+	}
+	for(; carry && i < n; ++i)
+		carry = ++out[i] == 0;
+
+	return carry;
+}
+
+// out[0, n) -= y[0, yn) with yn <= n; returns the borrow out of out[n - 1]
+std::uint64_t subtractInto(std::uint64_t* out, std::size_t n, const std::uint64_t* y, std::size_t yn)
+{
+	std::uint64_t borrow{ 0 };
+	std::size_t i{ 0 };
+	for(; i < yn; ++i)
+	{
+		const uint128 difference{ static_cast<uint128>(out[i]) - y[i] - borrow };
+		out[i] = static_cast<std::uint64_t>(difference);
+		borrow = static_cast<std::uint64_t>(difference >> 64) & 1;
+	}
+	for(; borrow && i < n; ++i)
+		borrow = out[i]-- == 0;
+
+	return borrow;
+}
+
+Limbs addMagnitude(const Limbs& x, const Limbs& y)
+{
+	const Limbs& longer{ x.size() >= y.size() ? x : y };
+	const Limbs& shorter{ x.size() >= y.size() ? y : x };
+
+	Limbs sum(longer);
+	if(addInto(sum.data(), sum.size(), shorter.data(), shorter.size()))
+		sum.push_back(1);
+
+	return sum;
+}
+
+// x >= y
+Limbs subtractMagnitude(const Limbs& x, const Limbs& y)
+{
+	Limbs difference(x);
+	subtractInto(difference.data(), difference.size(), y.data(), y.size());
+	trim(difference);
+
+	return difference;
+}
+
+// out[0, xn + yn) = x * y; out must not overlap the inputs
+void multiplySchoolbook(const std::uint64_t* x, std::size_t xn, const std::uint64_t* y, std::size_t yn, std::uint64_t* out)
+{
+	std::fill_n(out, xn + yn, 0);
+	for(std::size_t i{ 0 }; i < xn; ++i)
+	{
+		const std::uint64_t xi{ x[i] };
+		if(!xi)
+			continue;
+
+		std::uint64_t carry{ 0 };
+		for(std::size_t j{ 0 }; j < yn; ++j)
+		{
+			const uint128 product{ static_cast<uint128>(xi) * y[j] + out[i + j] + carry };
+			out[i + j] = static_cast<std::uint64_t>(product);
+			carry = static_cast<std::uint64_t>(product >> 64);
+		}
+		out[i + yn] = carry;
+	}
+}
+
+// Scratch limbs karatsuba() needs for n-limb operands
+std::size_t karatsubaScratch(std::size_t n)
+{
+	std::size_t total{ 0 };
+	while(n >= karatsubaThreshold)
+	{
+		const std::size_t m{ n - n / 2 + 1 };
+		total += 4 * m;
+		n = m;
+	}
+
+	return total;
+}
+
+// out[0, 2n) = x[0, n) * y[0, n).
+// x = x1 B^h + x0 and y = y1 B^h + y0 give x y = z2 B^2h + (z1 - z2 - z0) B^h + z0
+// with z0 = x0 y0, z2 = x1 y1 and z1 = (x0 + x1)(y0 + y1): three half-size products instead of four.
+void karatsuba(const std::uint64_t* x, const std::uint64_t* y, std::size_t n, std::uint64_t* out, std::uint64_t* scratch)
+{
+	if(n < karatsubaThreshold)
+	{
+		multiplySchoolbook(x, n, y, n, out);
+		return;
+	}
+
+	const std::size_t h{ n / 2 };
+	const std::size_t high{ n - h };        // >= h
+	const std::size_t m{ high + 1 };        // the sums may carry into one more limb
+
+	karatsuba(x, y, h, out, scratch);
+	karatsuba(x + h, y + h, high, out + 2 * h, scratch);
+
+	std::uint64_t* xSum{ scratch };
+	std::uint64_t* ySum{ scratch + m };
+	std::uint64_t* middle{ scratch + 2 * m };       // 2m limbs
+	std::uint64_t* rest{ scratch + 4 * m };
+
+	std::copy_n(x + h, high, xSum);
+	xSum[high] = addInto(xSum, high, x, h);
+	std::copy_n(y + h, high, ySum);
+	ySum[high] = addInto(ySum, high, y, h);
+
+	karatsuba(xSum, ySum, m, middle, rest);
+	subtractInto(middle, 2 * m, out, 2 * h);
+	subtractInto(middle, 2 * m, out + 2 * h, 2 * high);
+
+	// the middle term is below B^(2 high + 1), so the top limb is always zero here
+	addInto(out + h, 2 * n - h, middle, std::min(2 * m, 2 * n - h));
+}
+
+Limbs multiplyMagnitude(const Limbs& x, const Limbs& y)
+{
+	if(x.empty() || y.empty())
+		return {};
+
+	const Limbs& longer{ x.size() >= y.size() ? x : y };
+	const Limbs& shorter{ x.size() >= y.size() ? y : x };
+	const std::size_t n{ shorter.size() };
+
+	Limbs product(longer.size() + n);
+	if(n < karatsubaThreshold)
+	{
+		multiplySchoolbook(longer.data(), longer.size(), shorter.data(), n, product.data());
+		trim(product);
+		return product;
+	}
+
+	// cut the longer operand into n-limb pieces, each a balanced Karatsuba product
+	Limbs scratch(karatsubaScratch(n));
+	Limbs piece(2 * n);
+	Limbs padded(n);
+	for(std::size_t first{ 0 }; first < longer.size(); first += n)
+	{
+		const std::size_t size{ std::min(n, longer.size() - first) };
+		const std::uint64_t* part{ longer.data() + first };
+		if(size < n)
+		{
+			std::fill(std::copy_n(part, size, padded.begin()), padded.end(), 0);
+			part = padded.data();
+		}
+
+		karatsuba(part, shorter.data(), n, piece.data(), scratch.data());
+		addInto(product.data() + first, product.size() - first, piece.data(), std::min(2 * n, product.size() - first));
+	}
+
+	trim(product);
+	return product;
+}
+
+// x = x / divisor in place; returns the remainder
+std::uint64_t divideSmall(Limbs& x, std::uint64_t divisor)
+{
+	uint128 remainder{ 0 };
+	for(std::size_t i{ x.size() }; i-- > 0;)
+	{
+		const uint128 current{ (remainder << 64) | x[i] };
+		x[i] = static_cast<std::uint64_t>(current / divisor);
+		remainder = current % divisor;
+	}
+	trim(x);
+
+	return static_cast<std::uint64_t>(remainder);
+}
+
+Limbs shiftBitsLeft(const Limbs& x, unsigned shift, std::size_t extra)
+{
+	Limbs shifted(x.size() + extra);
+	std::uint64_t carry{ 0 };
+	for(std::size_t i{ 0 }; i < x.size(); ++i)
+	{
+		shifted[i] = (x[i] << shift) | carry;
+		carry = shift ? x[i] >> (64 - shift) : 0;
+	}
+	if(extra)
+		shifted[x.size()] = carry;
+
+	return shifted;
+}
+
+// Knuth's algorithm D: both operands are normalized so the top bit of the divisor is set,
+// which keeps each estimated quotient limb at most 2 too large. y has at least 2 limbs and x >= y.
+void divideKnuth(const Limbs& x, const Limbs& y, Limbs& quotient, Limbs& remainder)
+{
+	const auto shift{ static_cast<unsigned>(__builtin_clzll(y.back())) };
+	const Limbs v{ shiftBitsLeft(y, shift, 0) };
+	Limbs u{ shiftBitsLeft(x, shift, 1) };
+
+	const std::size_t n{ v.size() };
+	const std::size_t m{ x.size() - n };
+	quotient.assign(m + 1, 0);
+
+	for(std::size_t j{ m + 1 }; j-- > 0;)
+	{
+		const uint128 top{ (static_cast<uint128>(u[j + n]) << 64) | u[j + n - 1] };
+		uint128 estimate{ top / v[n - 1] };
+		uint128 rest{ top % v[n - 1] };
+		while((estimate >> 64) || estimate * v[n - 2] > ((rest << 64) | u[j + n - 2]))
+		{
+			--estimate;
+			rest += v[n - 1];
+			if(rest >> 64)
+				break;
+		}
+
+		// u[j, j + n] -= estimate * v
+		std::uint64_t carry{ 0 };
+		std::uint64_t borrow{ 0 };
+		for(std::size_t i{ 0 }; i < n; ++i)
+		{
+			const uint128 product{ static_cast<uint128>(static_cast<std::uint64_t>(estimate)) * v[i] + carry };
+			carry = static_cast<std::uint64_t>(product >> 64);
+			const uint128 difference{ static_cast<uint128>(u[i + j]) - static_cast<std::uint64_t>(product) - borrow };
+			u[i + j] = static_cast<std::uint64_t>(difference);
+			borrow = static_cast<std::uint64_t>(difference >> 64) & 1;
+		}
+		const uint128 difference{ static_cast<uint128>(u[j + n]) - carry - borrow };
+		u[j + n] = static_cast<std::uint64_t>(difference);
+
+		// the estimate was still one too large: add the divisor back
+		if(difference >> 64)
+		{
+			--estimate;
+			u[j + n] += addInto(u.data() + j, n, v.data(), n);
+		}
+
+		quotient[j] = static_cast<std::uint64_t>(estimate);
+	}
+
+	trim(quotient);
+
+	remainder.assign(u.begin(), u.begin() + static_cast<std::ptrdiff_t>(n));
+	if(shift)
+	{
+		for(std::size_t i{ 0 }; i < n; ++i)
+			remainder[i] = (remainder[i] >> shift) | (i + 1 < n ? remainder[i + 1] << (64 - shift) : 0);
+	}
+	trim(remainder);
+}
+
+// floor(B^2n / d) for an n-limb d, by Newton's iteration x' = x + x (B^2n - d x) / B^2n.
+// The starting point is the reciprocal of the top h limbs of d, computed the same way;
+// with h = n / 2 + 2 its relative error is below B^-(n/2 + 1), so one step leaves an error of a few units,
+// which the final loop removes.
+Limbs reciprocal(const Limbs& d)
+{
+	const std::size_t n{ d.size() };
+	Limbs power(2 * n + 1);
+	power.back() = 1;
+
+	if(n < newtonThreshold)
+	{
+		Limbs quotient{};
+		Limbs remainder{};
+		divideKnuth(power, d, quotient, remainder);
+		return quotient;
+	}
+
+	const std::size_t h{ n / 2 + 2 };
+	const std::size_t low{ n - h };
+	const Limbs top(d.end() - static_cast<std::ptrdiff_t>(h), d.end());
+	const Limbs start{ reciprocal(top) };
+
+	// x0 = start B^low, so d x0 = (d start) B^low and x0 e = (start e) B^low
+	Limbs dx{ multiplyMagnitude(d, start) };
+	dx.insert(dx.begin(), low, 0);
+
+	const bool below{ compareMagnitude(dx, power) <= 0 };       // sign of e = B^2n - d x0
+	const Limbs error{ below ? subtractMagnitude(power, dx) : subtractMagnitude(dx, power) };
+
+	Limbs correction{ multiplyMagnitude(start, error) };
+	const std::size_t drop{ 2 * n - low };
+	correction.erase(correction.begin(), correction.begin() + static_cast<std::ptrdiff_t>(std::min(drop, correction.size())));
+
+	Limbs estimate(start);
+	estimate.insert(estimate.begin(), low, 0);
+	estimate = below ? addMagnitude(estimate, correction) : subtractMagnitude(estimate, correction);
+
+	// make the estimate exact: 0 <= B^2n - d x < d
+	Limbs product{ multiplyMagnitude(d, estimate) };
+	const Limbs one{ 1 };
+	while(compareMagnitude(product, power) > 0)
+	{
+		estimate = subtractMagnitude(estimate, one);
+		product = subtractMagnitude(product, d);
+	}
+	while(true)
+	{
+		Limbs next{ addMagnitude(product, d) };
+		if(compareMagnitude(next, power) > 0)
+			break;
+
+		estimate = addMagnitude(estimate, one);
+		product = std::move(next);
+	}
+
+	return estimate;
+}
+
+// x / d and x % d for x < B^2n, with r = reciprocal(d) and n = d.size().
+// x r / B^2n is at most 2 below the true quotient.
+void divideWithReciprocal(const Limbs& x, const Limbs& d, const Limbs& r, Limbs& quotient, Limbs& remainder)
+{
+	const std::size_t n{ d.size() };
+	quotient = multiplyMagnitude(x, r);
+	quotient.erase(quotient.begin(), quotient.begin() + static_cast<std::ptrdiff_t>(std::min(2 * n, quotient.size())));
+
+	remainder = subtractMagnitude(x, multiplyMagnitude(quotient, d));
+	const Limbs one{ 1 };
+	while(compareMagnitude(remainder, d) >= 0)
+	{
+		remainder = subtractMagnitude(remainder, d);
+		quotient = addMagnitude(quotient, one);
+	}
+}
+
+void divideMagnitude(const Limbs& x, const Limbs& y, Limbs& quotient, Limbs& remainder)
+{
+	if(compareMagnitude(x, y) < 0)
+	{
+		quotient.clear();
+		remainder = x;
+		return;
+	}
+
+	if(y.size() == 1)
+	{
+		quotient = x;
+		const std::uint64_t rest{ divideSmall(quotient, y[0]) };
+		remainder.clear();
+		if(rest)
+			remainder.push_back(rest);
+		return;
+	}
+
+	const std::size_t n{ y.size() };
+	if(n < newtonThreshold || x.size() - n < newtonThreshold)
+	{
+		divideKnuth(x, y, quotient, remainder);
+		return;
+	}
+
+	// long division in base B^n: each step divides (remainder B^n + next n limbs) < y B^n <= B^2n
+	const Limbs r{ reciprocal(y) };
+	const std::size_t pieces{ (x.size() + n - 1) / n };
+	quotient.assign(pieces * n, 0);
+	remainder.clear();
+	for(std::size_t piece{ pieces }; piece-- > 0;)
+	{
+		const std::size_t first{ piece * n };
+		const std::size_t last{ std::min(x.size(), first + n) };
+
+		Limbs current(x.begin() + static_cast<std::ptrdiff_t>(first), x.begin() + static_cast<std::ptrdiff_t>(last));
+		if(!remainder.empty())
+		{
+			current.resize(n, 0);
+			current.insert(current.end(), remainder.begin(), remainder.end());
+		}
+		trim(current);
+
+		Limbs part{};
+		divideWithReciprocal(current, y, r, part, remainder);
+		std::copy(part.begin(), part.end(), quotient.begin() + static_cast<std::ptrdiff_t>(first));
+	}
+
+	trim(quotient);
+}
+
+// ---- decimal conversion --------------------------------------------------------------------------
+
+// powers[k] = 10^(19 2^k), with the reciprocal of each for repeated division.
+// The last power squared has more limbs than a number of the given size.
+struct DecimalPower
+{
+	Limbs value{};
+	Limbs reciprocal{};
+};
+
+std::vector<DecimalPower> decimalPowers(std::size_t limbs)
+{
+	std::vector<DecimalPower> powers{ { Limbs{ tenTo19 }, {} } };
+	while(powers.back().value.size() * 2 < limbs + 2)
+		powers.push_back({ multiplyMagnitude(powers.back().value, powers.back().value), {} });
+
+	for(DecimalPower& power : powers)
+	{
+		if(power.value.size() >= newtonThreshold)
+			power.reciprocal = reciprocal(power.value);
+	}
+
+	return powers;
+}
+
+// Appends x, which is below 10^(19 2^(level + 1)), padded with zeros to that width when pad is set
+void appendDecimal(const Limbs& x, std::size_t level, bool pad, const std::vector<DecimalPower>& powers, std::string& out)
+{
+	const std::size_t width{ digitsPerLimb << (level + 1) };
+	if(x.size() <= decimalThreshold || level == 0)
+	{
+		// peel 19 digits at a time off the bottom
+		Limbs rest{ x };
+		std::string digits{};
+		while(!rest.empty())
+		{
+			std::uint64_t chunk{ divideSmall(rest, tenTo19) };
+			for(std::size_t i{ 0 }; i < digitsPerLimb && (chunk || !rest.empty()); ++i)
+			{
+				digits.push_back(static_cast<char>('0' + chunk % 10));
+				chunk /= 10;
+			}
+		}
+
+		if(pad && digits.size() < width)
+			out.append(width - digits.size(), '0');
+		out.append(digits.rbegin(), digits.rend());
+		return;
+	}
+
+	const DecimalPower& power{ powers[level] };
+	Limbs high{};
+	Limbs low{};
+	if(power.reciprocal.empty())
+		divideMagnitude(x, power.value, high, low);
+	else
+		divideWithReciprocal(x, power.value, power.reciprocal, high, low);
+
+	if(high.empty() && !pad)
+	{
+		appendDecimal(low, level - 1, false, powers, out);
+		return;
+	}
+
+	appendDecimal(high, level - 1, pad, powers, out);
+	appendDecimal(low, level - 1, true, powers, out);
+}
+
+// ---- BigInt ---------------------------------------------------------------------------------------
+
+void BigInt::normalize()
+{
+	trim(m_limbs);
+	if(m_limbs.empty())
+		m_negative = false;
+}
+
+bool BigInt::fromString(std::string_view text, BigInt& out)
+{
+	bool negative{ false };
+	if(!text.empty() && (text.front() == '-' || text.front() == '+'))
+	{
+		negative = text.front() == '-';
+		text.remove_prefix(1);
+	}
+
+	if(text.empty() || text.find_first_not_of("0123456789") != std::string_view::npos)
+		return false;
+
+	// 19-digit chunks, least significant first, then merged pairwise: level k joins numbers of 19 2^k digits
+	std::vector<Limbs> parts{};
+	for(std::size_t end{ text.size() }; end > 0;)
+	{
+		const std::size_t begin{ end > digitsPerLimb ? end - digitsPerLimb : 0 };
+		std::uint64_t chunk{ 0 };
+		for(std::size_t i{ begin }; i < end; ++i)
+			chunk = chunk * 10 + static_cast<std::uint64_t>(text[i] - '0');
+
+		parts.push_back(chunk ? Limbs{ chunk } : Limbs{});
+		end = begin;
+	}
+
+	Limbs power{ tenTo19 };
+	while(parts.size() > 1)
+	{
+		std::vector<Limbs> merged((parts.size() + 1) / 2);
+		for(std::size_t i{ 0 }; i < merged.size(); ++i)
+		{
+			merged[i] = std::move(parts[2 * i]);
+			if(2 * i + 1 < parts.size())
+				merged[i] = addMagnitude(merged[i], multiplyMagnitude(parts[2 * i + 1], power));
+		}
+		parts = std::move(merged);
+		if(parts.size() > 1)
+			power = multiplyMagnitude(power, power);
+	}
+
+	out.m_limbs = std::move(parts.front());
+	out.m_negative = negative;
+	out.normalize();
+
+	return true;
+}
+
+std::string BigInt::toString() const
+{
+	if(isZero())
+		return "0";
+
+	const std::vector<DecimalPower> powers{ decimalPowers(m_limbs.size()) };
+
+	// smallest level with *this below powers[level + 1] = powers[level]^2, or below the last power squared
+	std::size_t level{ 0 };
+	while(level + 1 < powers.size() && compareMagnitude(m_limbs, powers[level + 1].value) >= 0)
+		++level;
+
+	std::string out{ m_negative ? "-" : "" };
+	appendDecimal(m_limbs, level, false, powers, out);
+
+	return out;
+}
+
+BigInt BigInt::operator-() const
+{
+	BigInt negated{ *this };
+	if(!negated.isZero())
+		negated.m_negative = !negated.m_negative;
+
+	return negated;
+}
+
+BigInt& BigInt::operator+=(const BigInt& other)
+{
+	if(m_negative == other.m_negative)
+	{
+		m_limbs = addMagnitude(m_limbs, other.m_limbs);
+		return *this;
+	}
+
+	// different signs: subtract the smaller magnitude from the larger, which keeps its sign
+	if(compareMagnitude(m_limbs, other.m_limbs) >= 0)
+	{
+		m_limbs = subtractMagnitude(m_limbs, other.m_limbs);
+	}
+	else
+	{
+		m_limbs = subtractMagnitude(other.m_limbs, m_limbs);
+		m_negative = other.m_negative;
+	}
+
+	normalize();
+	return *this;
+}
+
+BigInt& BigInt::operator-=(const BigInt& other)
+{
+	return *this += -other;
+}
+
+BigInt operator*(const BigInt& x, const BigInt& y)
+{
+	BigInt product{};
+	product.m_limbs = multiplyMagnitude(x.m_limbs, y.m_limbs);
+	product.m_negative = x.m_negative != y.m_negative;
+	product.normalize();
+
+	return product;
+}
+
+BigInt& BigInt::operator*=(const BigInt& other)
+{
+	return *this = *this * other;
+}
+
+void divide(const BigInt& x, const BigInt& y, BigInt* quotient, BigInt* remainder)
+{
+	assert(!y.isZero() && "Division by zero");
+
+	Limbs q{};
+	Limbs r{};
+	divideMagnitude(x.m_limbs, y.m_limbs, q, r);
+
+	if(quotient)
+	{
+		quotient->m_limbs = std::move(q);
+		quotient->m_negative = x.m_negative != y.m_negative;
+		quotient->normalize();
+	}
+	if(remainder)
+	{
+		remainder->m_limbs = std::move(r);
+		remainder->m_negative = x.m_negative;
+		remainder->normalize();
+	}
+}
+
+BigInt operator/(const BigInt& x, const BigInt& y)
+{
+	BigInt quotient{};
+	divide(x, y, &quotient, nullptr);
+
+	return quotient;
+}
+
+BigInt operator%(const BigInt& x, const BigInt& y)
+{
+	BigInt remainder{};
+	divide(x, y, nullptr, &remainder);
+
+	return remainder;
+}
+
+BigInt& BigInt::operator/=(const BigInt& other)
+{
+	return *this = *this / other;
+}
+
+BigInt& BigInt::operator%=(const BigInt& other)
+{
+	return *this = *this % other;
+}
+
+int compare(const BigInt& x, const BigInt& y)
+{
+	if(x.m_negative != y.m_negative)
+		return x.m_negative ? -1 : 1;
+
+	const int magnitude{ compareMagnitude(x.m_limbs, y.m_limbs) };
+	return x.m_negative ? -magnitude : magnitude;
+}
+
+std::ostream& operator<<(std::ostream& out, const BigInt& value)
+{
+	return out << value.toString();
+}
+
+std::istream& operator>>(std::istream& in, BigInt& value)
+{
+	std::string text{};
+	if(in >> text && !BigInt::fromString(text, value))
+		in.setstate(std::ios_base::failbit);
+
+	return in;
+}
@@ -0,0 +1,114 @@
+#ifndef BIGINT_H
+#define BIGINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Arbitrary-precision signed integer that behaves like the built-in integers where they are defined:
+// + - * / % with / truncating toward zero and % taking the sign of the dividend, and all comparisons.
+// Any integer type converts implicitly, so templates written for int (factorial, calculate) take it unchanged.
+// Multiplication is schoolbook for small operands and Karatsuba above a threshold; division is schoolbook
+// (Knuth D) for small divisors and Newton reciprocals for large ones; decimal conversion splits by powers of 10^19.
+class BigInt
+{
+private:
+	std::vector<std::uint64_t> m_limbs{};       // magnitude, least significant limb first, no leading zero limbs
+	bool m_negative{ false };                   // never set for zero
+
+	void normalize();
+
+	template <typename T>
+	void assign(T value)
+	{
+		if constexpr(std::is_signed_v<T>)
+		{
+			m_negative = value < 0;
+			// negate in unsigned so the most negative value does not overflow
+			const auto magnitude{ static_cast<std::uint64_t>(value) };
+			assignMagnitude(m_negative ? 0 - magnitude : magnitude);
+		}
+		else
+		{
+			assignMagnitude(static_cast<std::uint64_t>(value));
+		}
+	}
+
+	void assignMagnitude(std::uint64_t magnitude)
+	{
+		m_limbs.clear();
+		if(magnitude)
+			m_limbs.push_back(magnitude);
+	}
+
+	friend void divide(const BigInt& x, const BigInt& y, BigInt* quotient, BigInt* remainder);
+
+public:
+	BigInt() = default;
+
+	template <typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+	BigInt(T value)
+	{
+		assign(value);
+	}
+
+	// Optional sign followed by decimal digits; false (and out unchanged) for anything else
+	static bool fromString(std::string_view text, BigInt& out);
+	std::string toString() const;
+
+	bool isZero() const { return m_limbs.empty(); }
+	bool isNegative() const { return m_negative; }
+	const std::vector<std::uint64_t>& limbs() const { return m_limbs; }
+
+	BigInt operator-() const;
+
+	BigInt& operator+=(const BigInt& other);
+	BigInt& operator-=(const BigInt& other);
+	BigInt& operator*=(const BigInt& other);
+	BigInt& operator/=(const BigInt& other);      // other must not be zero
+	BigInt& operator%=(const BigInt& other);      // other must not be zero
+
+	friend BigInt operator+(BigInt x, const BigInt& y) { return x += y; }
+	friend BigInt operator-(BigInt x, const BigInt& y) { return x -= y; }
+	friend BigInt operator*(const BigInt& x, const BigInt& y);
+	friend BigInt operator/(const BigInt& x, const BigInt& y);
+	friend BigInt operator%(const BigInt& x, const BigInt& y);
+
+	friend int compare(const BigInt& x, const BigInt& y);
+	friend bool operator==(const BigInt& x, const BigInt& y) { return compare(x, y) == 0; }
+	friend bool operator!=(const BigInt& x, const BigInt& y) { return compare(x, y) != 0; }
+	friend bool operator<(const BigInt& x, const BigInt& y) { return compare(x, y) < 0; }
+	friend bool operator<=(const BigInt& x, const BigInt& y) { return compare(x, y) <= 0; }
+	friend bool operator>(const BigInt& x, const BigInt& y) { return compare(x, y) > 0; }
+	friend bool operator>=(const BigInt& x, const BigInt& y) { return compare(x, y) >= 0; }
+
+	friend std::ostream& operator<<(std::ostream& out, const BigInt& value);
+	friend std::istream& operator>>(std::istream& in, BigInt& value);
+};
+
+// Quotient and remainder with one division; either pointer may be null. y must not be zero.
+void divide(const BigInt& x, const BigInt& y, BigInt* quotient, BigInt* remainder);
+
+// Lets BigInt key hash containers, such as the result cache of 12_Functions/008_calc
+template <>
+struct std::hash<BigInt>
+{
+	std::size_t operator()(const BigInt& value) const
+	{
+		std::uint64_t h{ value.isNegative() ? 0x9E37'79B9'7F4A'7C15u : 0u };
+		for(std::uint64_t limb : value.limbs())
+		{
+			h = (h ^ limb) * 0xBF58'476D'1CE4'E5B9;
+			h ^= h >> 31;
+		}
+
+		return static_cast<std::size_t>(h);
+	}
+};
+
+#endif
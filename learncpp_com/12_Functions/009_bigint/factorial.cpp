@@ -0,0 +1,88 @@
+#include "factorial.h"
+#include "bigint.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/thread_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Subtrees below this many words are multiplied up one word at a time
+constexpr std::size_t linearWords{ 16 };
+
+// Leaf tasks per pool thread; more leaves than threads keeps every worker busy until the tree narrows
+constexpr std::size_t leavesPerThread{ 4 };
+
+// Multiplies runs of consecutive factors into single words while they fit
+std::vector<std::uint64_t> packFactors(std::uint64_t lo, std::uint64_t hi)
+{
+	std::vector<std::uint64_t> words{};
+	std::uint64_t word{ 1 };
+	for(std::uint64_t k{ lo }; k <= hi && k != 0; ++k)
+	{
+		std::uint64_t product{};
+		if(__builtin_mul_overflow(word, k, &product))
+		{
+			words.push_back(word);
+			product = k;
+		}
+		word = product;
+
+		if(k == UINT64_MAX)
+			break;
+	}
+	if(word != 1)
+		words.push_back(word);
+
+	return words;
+}
+
+BigInt productOfWords(const std::uint64_t* words, std::size_t count)
+{
+	if(count <= linearWords)
+	{
+		BigInt product{ 1 };
+		for(std::size_t i{ 0 }; i < count; ++i)
+			product *= words[i];
+
+		return product;
+	}
+
+	const std::size_t half{ count / 2 };
+	return productOfWords(words, half) * productOfWords(words + half, count - half);
+}
+
+BigInt factorialProductTree(std::uint32_t n, ThreadPool* pool)
+{
+	const std::vector<std::uint64_t> words{ packFactors(2, n) };
+	if(!pool || pool->size() < 2 || words.size() < 2 * linearWords)
+		return productOfWords(words.data(), words.size());
+
+	// leaves: contiguous runs of words, each a sequential product tree
+	const std::size_t leafCount{ std::min(pool->size() * leavesPerThread, words.size() / linearWords) };
+	std::vector<BigInt> level(leafCount);
+	for(std::size_t i{ 0 }; i < leafCount; ++i)
+	{
+		const std::size_t first{ words.size() * i / leafCount };
+		const std::size_t last{ words.size() * (i + 1) / leafCount };
+		pool->submit([&level, &words, i, first, last] { level[i] = productOfWords(words.data() + first, last - first); },
+			     last - first);
+	}
+	pool->wait();
+
+	// the levels above: neighbours multiply in parallel, an odd one out moves up unchanged
+	while(level.size() > 1)
+	{
+		std::vector<BigInt> next((level.size() + 1) / 2);
+		for(std::size_t i{ 0 }; 2 * i + 1 < level.size(); ++i)
+			pool->submit([&level, &next, i] { next[i] = level[2 * i] * level[2 * i + 1]; });
+		if(level.size() % 2)
+			next.back() = std::move(level.back());
+		pool->wait();
+
+		level = std::move(next);
+	}
+
+	return std::move(level.front());
+}
@@ -0,0 +1,14 @@
+#ifndef FACTORIAL_H
+#define FACTORIAL_H
+
+#include "bigint.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/thread_pool.h"
+#include <cstdint>
+
+	// n! by binary splitting: the factors are packed into 64-bit words and multiplied as a balanced
+	// product tree, so every multiplication has operands of similar size and Karatsuba does the heavy lifting.
+	// With a pool the leaves are computed in parallel and each level of the tree above them multiplies its
+	// pairs in parallel; the final few products are single multiplications and run on one thread.
+	BigInt factorialProductTree(std::uint32_t n, ThreadPool* pool = nullptr);
+
+#endif
@@ -0,0 +1,85 @@
+// Usage: factorial_benchmark [n=1000000] [--digits]
+// Times n! by the product tree on 1, 2, 4, ... threads up to the hardware concurrency and reports
+// the speedup over one thread; a smaller n is also timed the way 002_factorial.cpp computes it,
+// one multiplication at a time. --digits also converts the result to decimal and prints its length.
+
+// Build: g++ -std=c++17 -O2 -pthread factorial_benchmark.cpp factorial.cpp bigint.cpp ../../08_Control_Flow_and_Error_Handling/008_primality/thread_pool.cpp
+
+#include "bigint.h"
+#include "factorial.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/thread_pool.h"
+#include "../../08_Control_Flow_and_Error_Handling/008_primality/timer.h"
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// n * (n - 1)! as in 002_factorial.cpp, written as a loop
+BigInt factorialLinear(std::uint32_t n)
+{
+	BigInt product{ 1 };
+	for(std::uint32_t k{ 2 }; k <= n; ++k)
+		product *= k;
+
+	return product;
+}
+
+int main(int argc, char* argv[])
+{
+	std::uint32_t n{ 1'000'000 };
+	bool digits{ false };
+	for(int i{ 1 }; i < argc; ++i)
+	{
+		const std::string arg{ argv[i] };
+		if(arg == "--digits")
+			digits = true;
+		else
+			n = static_cast<std::uint32_t>(std::stoul(arg));
+	}
+
+	const std::uint32_t small{ std::min<std::uint32_t>(n, 50'000) };
+	Timer timer{};
+	const BigInt linear{ factorialLinear(small) };
+	const double linearSeconds{ timer.elapsed() };
+	timer.reset();
+	const bool linearMatches{ factorialProductTree(small) == linear };
+	std::cout << small << "!  one factor at a time: " << linearSeconds << " s, product tree: " << timer.elapsed() << " s"
+		  << (linearMatches ? "" : "  RESULTS DIFFER") << "\n\n";
+
+	const std::size_t hardware{ std::max(1u, std::thread::hardware_concurrency()) };
+	std::vector<std::size_t> threadCounts{};
+	for(std::size_t threads{ 1 }; threads < hardware; threads *= 2)
+		threadCounts.push_back(threads);
+	threadCounts.push_back(hardware);
+
+	BigInt reference{};
+	double oneThreadSeconds{ 0 };
+	for(const std::size_t threads : threadCounts)
+	{
+		ThreadPool pool{ threads };
+		timer.reset();
+		const BigInt result{ factorialProductTree(n, threads > 1 ? &pool : nullptr) };
+		const double seconds{ timer.elapsed() };
+
+		if(threads == 1)
+		{
+			reference = result;
+			oneThreadSeconds = seconds;
+		}
+
+		std::cout << n << "!  " << threads << " thread" << (threads > 1 ? "s: " : ":  ") << seconds << " s, speedup "
+			  << oneThreadSeconds / seconds << (result == reference ? "" : "  RESULTS DIFFER") << '\n';
+	}
+
+	std::cout << reference.limbs().size() << " limbs\n";
+	if(digits)
+	{
+		timer.reset();
+		const std::string decimal{ reference.toString() };
+		std::cout << decimal.size() << " decimal digits (" << timer.elapsed() << " s to convert)\n";
+	}
+
+	return 0;
+}